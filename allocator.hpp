@@ -0,0 +1,224 @@
+#ifndef SJTU_ALLOCATOR_HPP
+#define SJTU_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace sjtu {
+// Hands out memory from large chunks by bumping a pointer. Deallocation is
+// a no-op; everything is given back at once by release() or the
+// destructor. Containers using it must be destroyed before that happens.
+// Not thread-safe: use one arena per thread.
+class monotonic_arena {
+  struct chunk {
+    chunk *next;
+    size_t size;
+  };
+  // keeps the first block in a chunk maximally aligned
+  static constexpr size_t header_size =
+      (sizeof(chunk) + alignof(std::max_align_t) - 1) /
+      alignof(std::max_align_t) * alignof(std::max_align_t);
+
+  chunk *chunks = nullptr;
+  char *cur = nullptr;
+  size_t left = 0;
+  size_t initial_size;
+  size_t next_size;
+  size_t used = 0;
+
+public:
+  explicit monotonic_arena(size_t initial_chunk_size = 4096)
+      : initial_size(initial_chunk_size), next_size(initial_chunk_size) {}
+  monotonic_arena(const monotonic_arena &) = delete;
+  monotonic_arena &operator=(const monotonic_arena &) = delete;
+  ~monotonic_arena() { release(); }
+
+  void *allocate(size_t bytes, size_t align) {
+    size_t pad = (align - (uintptr_t)cur % align) % align;
+    if (cur == nullptr || pad + bytes > left) {
+      size_t size = next_size;
+      if (size < bytes + align)
+        size = bytes + align;
+      chunk *c = (chunk *)::operator new(header_size + size);
+      c->next = chunks;
+      c->size = size;
+      chunks = c;
+      cur = (char *)c + header_size;
+      left = size;
+      next_size *= 2;
+      pad = (align - (uintptr_t)cur % align) % align;
+    }
+    void *p = cur + pad;
+    cur += pad + bytes;
+    left -= pad + bytes;
+    used += bytes;
+    return p;
+  }
+
+  void deallocate(void *, size_t) {}
+
+  // frees every chunk in one go
+  void release() {
+    while (chunks) {
+      chunk *next = chunks->next;
+      ::operator delete(chunks);
+      chunks = next;
+    }
+    cur = nullptr;
+    left = 0;
+    used = 0;
+    next_size = initial_size;
+  }
+
+  size_t bytes_allocated() const { return used; }
+};
+
+// Keeps a free list for each power-of-two size class up to max_block bytes,
+// refilled from slabs. Bigger requests go straight to operator new. Freed
+// blocks are reused by later requests of the same class; slabs are only
+// returned by release() or the destructor. Not thread-safe: use one pool per
+// thread.
+class pool_resource {
+  struct node {
+    node *next;
+  };
+  static constexpr size_t min_shift = 3;
+  static constexpr size_t max_shift = 12;
+  static constexpr size_t slab_size = 64 * 1024;
+  static constexpr size_t header_size =
+      (sizeof(node) + alignof(std::max_align_t) - 1) /
+      alignof(std::max_align_t) * alignof(std::max_align_t);
+
+  node *free_lists[max_shift - min_shift + 1] = {};
+  node *slabs = nullptr;
+
+  static size_t size_class(size_t bytes) {
+    size_t c = 0;
+    while (((size_t)1 << (c + min_shift)) < bytes)
+      c++;
+    return c;
+  }
+
+  void refill(size_t c) {
+    size_t block = (size_t)1 << (c + min_shift);
+    node *slab = (node *)::operator new(header_size + slab_size);
+    slab->next = slabs;
+    slabs = slab;
+    char *p = (char *)slab + header_size;
+    for (size_t i = 0; i + block <= slab_size; i += block) {
+      node *n = (node *)(p + i);
+      n->next = free_lists[c];
+      free_lists[c] = n;
+    }
+  }
+
+public:
+  static constexpr size_t max_block = (size_t)1 << max_shift;
+
+  pool_resource() = default;
+  pool_resource(const pool_resource &) = delete;
+  pool_resource &operator=(const pool_resource &) = delete;
+  ~pool_resource() { release(); }
+
+  void *allocate(size_t bytes, size_t align) {
+    if (align > alignof(std::max_align_t))
+      return ::operator new(bytes, std::align_val_t(align));
+    if (bytes > max_block)
+      return ::operator new(bytes);
+    size_t c = size_class(bytes);
+    if (free_lists[c] == nullptr)
+      refill(c);
+    node *n = free_lists[c];
+    free_lists[c] = n->next;
+    return n;
+  }
+
+  void deallocate(void *p, size_t bytes, size_t align) {
+    if (align > alignof(std::max_align_t)) {
+      ::operator delete(p, std::align_val_t(align));
+    } else if (bytes > max_block) {
+      ::operator delete(p);
+    } else {
+      size_t c = size_class(bytes);
+      node *n = (node *)p;
+      n->next = free_lists[c];
+      free_lists[c] = n;
+    }
+  }
+
+  // frees every slab; blocks bigger than max_block are not tracked and
+  // must have been deallocated already
+  void release() {
+    while (slabs) {
+      node *next = slabs->next;
+      ::operator delete(slabs);
+      slabs = next;
+    }
+    for (size_t c = 0; c <= max_shift - min_shift; c++)
+      free_lists[c] = nullptr;
+  }
+};
+
+template <typename T> class arena_allocator {
+  template <typename U> friend class arena_allocator;
+
+  monotonic_arena *arena;
+
+public:
+  using value_type = T;
+
+  arena_allocator(monotonic_arena &a) noexcept : arena(&a) {}
+  template <typename U>
+  arena_allocator(const arena_allocator<U> &other) noexcept
+      : arena(other.arena) {}
+
+  T *allocate(size_t n) {
+    if (n > SIZE_MAX / sizeof(T))
+      throw std::bad_alloc();
+    return (T *)arena->allocate(n * sizeof(T), alignof(T));
+  }
+  void deallocate(T *, size_t) noexcept {}
+
+  template <typename U>
+  bool operator==(const arena_allocator<U> &rhs) const {
+    return arena == rhs.arena;
+  }
+  template <typename U>
+  bool operator!=(const arena_allocator<U> &rhs) const {
+    return arena != rhs.arena;
+  }
+};
+
+template <typename T> class pool_allocator {
+  template <typename U> friend class pool_allocator;
+
+  pool_resource *pool;
+
+public:
+  using value_type = T;
+
+  pool_allocator(pool_resource &p) noexcept : pool(&p) {}
+  template <typename U>
+  pool_allocator(const pool_allocator<U> &other) noexcept
+      : pool(other.pool) {}
+
+  T *allocate(size_t n) {
+    if (n > SIZE_MAX / sizeof(T))
+      throw std::bad_alloc();
+    return (T *)pool->allocate(n * sizeof(T), alignof(T));
+  }
+  void deallocate(T *p, size_t n) noexcept {
+    pool->deallocate(p, n * sizeof(T), alignof(T));
+  }
+
+  template <typename U> bool operator==(const pool_allocator<U> &rhs) const {
+    return pool == rhs.pool;
+  }
+  template <typename U> bool operator!=(const pool_allocator<U> &rhs) const {
+    return pool != rhs.pool;
+  }
+};
+} // namespace sjtu
+
+#endif
@@ -0,0 +1,25 @@
+#!/bin/bash
+
+# Builds and runs the vector, concurrent_vector and Bint microbenchmarks
+# with optimization.
+# Extra arguments go to every benchmark binary, e.g.
+#   ./bench.sh --filter='long long' --max-size=65536 --min-time=0.5
+
+mkdir -p bench_build
+
+g++ -O2 -std=c++17 -I ./data ./bench/bench_vector.cpp -o ./bench_build/bench_vector &&
+g++ -O2 -std=c++17 -I ./data ./bench/bench_concurrent.cpp -o ./bench_build/bench_concurrent &&
+g++ -O2 -std=c++17 -I ./data ./bench/bench_bint.cpp -o ./bench_build/bench_bint
+if [ $? -ne 0 ];
+then
+    echo "Fail to build benchmarks!"
+    exit 1
+fi;
+
+{
+    ./bench_build/bench_vector "$@"
+    ./bench_build/bench_concurrent "$@"
+    ./bench_build/bench_bint "$@"
+} | tee bench_output.txt
+
+rm -rf bench_build
@@ -0,0 +1,211 @@
+#ifndef SJTU_BENCH_HPP
+#define SJTU_BENCH_HPP
+
+// A tiny Google-Benchmark-style harness: register functions taking a
+// bench::state, loop on state.keep_running(), and main() calibrates the
+// iteration count and prints ns/op and heap bytes per iteration.
+//
+// Heap usage is measured by replacing the global operator new/delete, so
+// this header must be included by exactly one translation unit.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+namespace detail {
+// atomic so that benchmarks may allocate from several threads
+inline std::atomic<size_t> &allocated_bytes() {
+  static std::atomic<size_t> bytes{0};
+  return bytes;
+}
+inline std::atomic<size_t> &allocation_count() {
+  static std::atomic<size_t> count{0};
+  return count;
+}
+} // namespace detail
+
+template <typename T> inline void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber_memory() { asm volatile("" : : : "memory"); }
+
+class state {
+  using clock = std::chrono::steady_clock;
+
+  size_t target;
+  size_t done = 0;
+  clock::time_point started;
+  clock::time_point stopped;
+  clock::duration paused_for{0};
+  clock::time_point paused_at;
+  size_t bytes_at_start = 0;
+  size_t bytes_paused = 0;
+  size_t bytes_at_pause = 0;
+  size_t count_at_start = 0;
+  size_t count_paused = 0;
+  size_t count_at_pause = 0;
+  size_t bytes_at_stop = 0;
+  size_t count_at_stop = 0;
+
+public:
+  // the swept problem size
+  const size_t size;
+  // how many operations one iteration performs; ns/op divides by this
+  size_t ops_per_iteration = 1;
+
+  state(size_t n, size_t iterations) : target(iterations), size(n) {}
+
+  bool keep_running() {
+    if (done == 0) {
+      bytes_at_start = detail::allocated_bytes();
+      count_at_start = detail::allocation_count();
+      started = clock::now();
+    }
+    // stop the clock here, before the benchmark's locals are destroyed
+    if (done == target) {
+      stopped = clock::now();
+      bytes_at_stop = detail::allocated_bytes();
+      count_at_stop = detail::allocation_count();
+      return false;
+    }
+    done++;
+    return true;
+  }
+
+  // excludes setup work inside the loop from the measurement
+  void pause_timing() {
+    paused_at = clock::now();
+    bytes_at_pause = detail::allocated_bytes();
+    count_at_pause = detail::allocation_count();
+  }
+  void resume_timing() {
+    bytes_paused += detail::allocated_bytes() - bytes_at_pause;
+    count_paused += detail::allocation_count() - count_at_pause;
+    paused_for += clock::now() - paused_at;
+  }
+
+  double elapsed_ns() const {
+    return std::chrono::duration<double, std::nano>(stopped - started -
+                                                    paused_for)
+        .count();
+  }
+  size_t iterations() const { return target; }
+  size_t bytes_allocated() const {
+    return bytes_at_stop - bytes_at_start - bytes_paused;
+  }
+  size_t allocations() const {
+    return count_at_stop - count_at_start - count_paused;
+  }
+};
+
+struct benchmark {
+  std::string name;
+  void (*fn)(state &);
+  std::vector<size_t> sizes;
+};
+
+inline std::vector<benchmark> &registry() {
+  static std::vector<benchmark> list;
+  return list;
+}
+
+inline int add(const std::string &name, void (*fn)(state &),
+               std::vector<size_t> sizes) {
+  registry().push_back({name, fn, sizes});
+  return 0;
+}
+
+// sizes from `lo` to `hi` (inclusive), multiplying by `step`
+inline std::vector<size_t> range(size_t lo, size_t hi, size_t step = 8) {
+  std::vector<size_t> sizes;
+  for (size_t n = lo; n <= hi; n *= step)
+    sizes.push_back(n);
+  return sizes;
+}
+
+// usage: bench [--filter=substring] [--min-time=seconds] [--max-size=n]
+inline int run_all(int argc, char **argv) {
+  std::string filter;
+  double min_time = 0.2;
+  size_t max_size = (size_t)-1;
+  for (int i = 1; i < argc; i++) {
+    if (std::strncmp(argv[i], "--filter=", 9) == 0)
+      filter = argv[i] + 9;
+    else if (std::strncmp(argv[i], "--min-time=", 11) == 0)
+      min_time = std::atof(argv[i] + 11);
+    else if (std::strncmp(argv[i], "--max-size=", 11) == 0)
+      max_size = std::strtoull(argv[i] + 11, nullptr, 10);
+  }
+  std::printf("%-52s %14s %12s %14s %10s\n", "benchmark", "ns/op",
+              "iterations", "bytes/iter", "allocs/iter");
+  for (benchmark &b : registry()) {
+    if (b.name.find(filter) == std::string::npos)
+      continue;
+    for (size_t n : b.sizes) {
+      if (n > max_size)
+        continue;
+      size_t iterations = 1;
+      while (true) {
+        state st(n, iterations);
+        b.fn(st);
+        double ns = st.elapsed_ns();
+        if (ns >= min_time * 1e9 || iterations >= ((size_t)1 << 30)) {
+          std::string label = b.name + "/" + std::to_string(n);
+          std::printf("%-52s %14.2f %12zu %14zu %10zu\n", label.c_str(),
+                      ns / iterations / st.ops_per_iteration, iterations,
+                      st.bytes_allocated() / iterations,
+                      st.allocations() / iterations);
+          std::fflush(stdout);
+          break;
+        }
+        // aim a little past the minimum so the next round usually ends it
+        double per_iteration = ns / iterations;
+        size_t next = per_iteration > 0
+                          ? (size_t)(min_time * 1.2e9 / per_iteration)
+                          : iterations * 10;
+        if (next > iterations * 10)
+          next = iterations * 10;
+        iterations = next > iterations ? next : iterations * 2;
+      }
+    }
+  }
+  return 0;
+}
+namespace detail {
+// frees what the operator new below took from malloc. Kept out of line:
+// once inlined into a delete expression, GCC pairs the free with that
+// new and warns under -Wmismatched-new-delete.
+__attribute__((noinline)) void release(void *p) noexcept { std::free(p); }
+} // namespace detail
+} // namespace bench
+
+void *operator new(size_t n) {
+  bench::detail::allocated_bytes().fetch_add(n, std::memory_order_relaxed);
+  bench::detail::allocation_count().fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(n ? n : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { bench::detail::release(p); }
+void operator delete(void *p, size_t) noexcept { bench::detail::release(p); }
+void *operator new[](size_t n) { return operator new(n); }
+void operator delete[](void *p) noexcept { bench::detail::release(p); }
+void operator delete[](void *p, size_t) noexcept { bench::detail::release(p); }
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+// BENCHMARK(name, fn, sizes): registers `fn` to run for every size
+#define BENCHMARK(name, fn, sizes)                                             \
+  static int BENCH_CONCAT(bench_registered_, __LINE__) =                      \
+      bench::add(name, fn, sizes)
+
+#endif
@@ -0,0 +1,127 @@
+// Microbenchmarks for Util::Bint arithmetic and decimal conversion.
+// Build and run with ./bench.sh from the repository root; the size is the
+// number of decimal digits of each operand.
+
+#include "bench.hpp"
+
+#include "class-bint.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// a pseudo-random number with exactly `digits` decimal digits
+std::string digits_of(size_t digits, unsigned seed) {
+  std::string s(digits, '0');
+  for (size_t i = 0; i < digits; i++) {
+    seed = seed * 1103515245u + 12345u;
+    s[i] = (char)('0' + (seed >> 16) % 10);
+  }
+  s[0] = s[0] == '0' ? '7' : s[0];
+  return s;
+}
+
+void bm_add(bench::state &st) {
+  Util::Bint a(digits_of(st.size, 1)), b(digits_of(st.size, 2));
+  while (st.keep_running()) {
+    Util::Bint c = a + b;
+    bench::do_not_optimize(c);
+  }
+}
+
+void bm_multiply(bench::state &st) {
+  Util::Bint a(digits_of(st.size, 1)), b(digits_of(st.size, 2));
+  while (st.keep_running()) {
+    Util::Bint c = a * b;
+    bench::do_not_optimize(c);
+  }
+}
+
+// multiply() picks a separate squaring kernel when both operands are equal
+void bm_square(bench::state &st) {
+  Util::Bint a(digits_of(st.size, 1)), b = a;
+  while (st.keep_running()) {
+    Util::Bint c = a * b;
+    bench::do_not_optimize(c);
+  }
+}
+
+// the shorter operand has a tenth of the digits
+void bm_multiply_unbalanced(bench::state &st) {
+  Util::Bint a(digits_of(st.size, 1)), b(digits_of(st.size / 10 + 1, 2));
+  while (st.keep_running()) {
+    Util::Bint c = a * b;
+    bench::do_not_optimize(c);
+  }
+}
+
+// a number with twice the digits by one with `size`, to set against
+// multiply
+void bm_divide(bench::state &st) {
+  Util::Bint a(digits_of(2 * st.size, 1)), b(digits_of(st.size, 2));
+  while (st.keep_running()) {
+    Util::Bint c = a / b;
+    bench::do_not_optimize(c);
+  }
+}
+
+void bm_divide_small(bench::state &st) {
+  Util::Bint a(digits_of(st.size, 1)), b(1000000007);
+  while (st.keep_running()) {
+    Util::Bint c = a / b;
+    bench::do_not_optimize(c);
+  }
+}
+
+// base, exponent and modulus all have `size` digits; odd moduli go
+// through Montgomery multiplication, even ones through division
+template <bool Odd> void bm_powmod(bench::state &st) {
+  std::string m = digits_of(st.size, 3);
+  m[m.size() - 1] = Odd ? '7' : '8';
+  Util::Bint a(digits_of(st.size, 1)), e(digits_of(st.size, 2)), mod(m);
+  while (st.keep_running()) {
+    Util::Bint c = powmod(a, e, mod);
+    bench::do_not_optimize(c);
+  }
+}
+
+void bm_parse(bench::state &st) {
+  std::string s = digits_of(st.size, 3);
+  while (st.keep_running()) {
+    Util::Bint a(s);
+    bench::do_not_optimize(a);
+  }
+}
+
+void bm_print(bench::state &st) {
+  Util::Bint a(digits_of(st.size, 4));
+  while (st.keep_running()) {
+    std::ostringstream os;
+    os << a;
+    bench::do_not_optimize(os.str().size());
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<size_t> sizes = bench::range(10, 100000, 10);
+  // products also sweep the sizes the NTT multiplier is meant for
+  std::vector<size_t> products = bench::range(10, 1000000, 10);
+  bench::add("add", bm_add, sizes);
+  bench::add("multiply", bm_multiply, products);
+  bench::add("square", bm_square, products);
+  bench::add("multiply_unbalanced", bm_multiply_unbalanced, products);
+  bench::add("divide", bm_divide, sizes);
+  bench::add("divide_small", bm_divide_small, sizes);
+  // every exponent bit costs a modular product
+  std::vector<size_t> moduli = bench::range(10, 1000, 10);
+  bench::add("powmod_odd", bm_powmod<true>, moduli);
+  bench::add("powmod_even", bm_powmod<false>, moduli);
+  // conversions split at powers of 10^9, so they scale like products
+  bench::add("parse", bm_parse, products);
+  bench::add("print", bm_print, products);
+  return bench::run_all(argc, argv);
+}
@@ -0,0 +1,84 @@
+// Many threads appending to one container: sjtu::concurrent_vector against
+// sjtu::vector and std::vector behind a mutex.
+// Build and run with ./bench.sh from the repository root.
+
+#include "bench.hpp"
+
+#include "../concurrent_vector.hpp"
+#include "../vector.hpp"
+
+#include "class-bint.hpp"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// elements appended per iteration, split evenly between the threads
+constexpr size_t total = (size_t)1 << 16;
+
+template <typename T> T make(size_t i);
+template <> long long make<long long>(size_t i) { return (long long)i; }
+template <> Util::Bint make<Util::Bint>(size_t i) {
+  return Util::Bint((long long)i);
+}
+
+template <typename F> void on_threads(size_t count, F fn) {
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < count; t++)
+    threads.emplace_back(fn, t);
+  for (std::thread &th : threads)
+    th.join();
+}
+
+// the benchmarked size is the number of threads
+template <typename T> void bm_concurrent(bench::state &st) {
+  size_t per_thread = total / st.size;
+  st.ops_per_iteration = per_thread * st.size;
+  while (st.keep_running()) {
+    sjtu::concurrent_vector<T> v;
+    on_threads(st.size, [&](size_t t) {
+      for (size_t i = 0; i < per_thread; i++)
+        v.push_back(make<T>(t * per_thread + i));
+    });
+    bench::do_not_optimize(v.size());
+  }
+}
+
+template <template <typename...> class V, typename T>
+void bm_locked(bench::state &st) {
+  size_t per_thread = total / st.size;
+  st.ops_per_iteration = per_thread * st.size;
+  while (st.keep_running()) {
+    V<T> v;
+    std::mutex lock;
+    on_threads(st.size, [&](size_t t) {
+      for (size_t i = 0; i < per_thread; i++) {
+        T value = make<T>(t * per_thread + i);
+        std::lock_guard<std::mutex> guard(lock);
+        v.push_back(std::move(value));
+      }
+    });
+    bench::do_not_optimize(v.size());
+  }
+}
+
+template <typename T> void add_type(const std::string &type) {
+  std::vector<size_t> threads = bench::range(1, 8, 2);
+  bench::add("push_back<concurrent, " + type + ">", bm_concurrent<T>,
+             threads);
+  bench::add("push_back<sjtu+mutex, " + type + ">",
+             bm_locked<sjtu::vector, T>, threads);
+  bench::add("push_back<std+mutex, " + type + ">", bm_locked<std::vector, T>,
+             threads);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  add_type<long long>("long long");
+  add_type<Util::Bint>("Bint");
+  return bench::run_all(argc, argv);
+}
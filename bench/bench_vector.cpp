@@ -0,0 +1,198 @@
+// Microbenchmarks for sjtu::vector against std::vector.
+// Build and run with ./bench.sh from the repository root.
+
+#include "bench.hpp"
+
+#include "../vector.hpp"
+
+#include "class-bint.hpp"
+#include "class-matrix.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+// the tests' Integer: an int with only a user-written copy constructor, so
+// vector has to copy it rather than move or memcpy it. The tests' version
+// relies on the implicit copy assignment, which is deprecated next to a
+// user-written copy constructor.
+class Integer {
+  int data;
+
+public:
+  Integer(int value) : data(value) {}
+  Integer(const Integer &other) : data(other.data) {}
+  Integer &operator=(const Integer &other) {
+    data = other.data;
+    return *this;
+  }
+};
+
+template <typename T> using sjtu_vector = sjtu::vector<T>;
+template <typename T> using std_vector = std::vector<T>;
+
+template <typename T> T make(size_t i);
+template <> long long make<long long>(size_t i) { return (long long)i; }
+template <> Integer make<Integer>(size_t i) { return Integer((int)i); }
+template <> Util::Bint make<Util::Bint>(size_t i) {
+  return Util::Bint((long long)i);
+}
+template <> Diamond::Matrix<double> make<Diamond::Matrix<double>>(size_t i) {
+  return Diamond::Matrix<double>(2, 2, (double)i);
+}
+
+template <template <typename> class V, typename T> V<T> filled(size_t n) {
+  V<T> v;
+  for (size_t i = 0; i < n; i++)
+    v.push_back(make<T>(i));
+  return v;
+}
+
+// front/middle insert and erase are O(n) each, so only this many run per
+// iteration
+constexpr size_t shifts = 16;
+
+template <template <typename> class V, typename T>
+void bm_push_back(bench::state &st) {
+  st.ops_per_iteration = st.size;
+  while (st.keep_running()) {
+    V<T> v;
+    for (size_t i = 0; i < st.size; i++)
+      v.push_back(make<T>(i));
+    bench::do_not_optimize(v.size());
+  }
+}
+
+template <template <typename> class V, typename T>
+void bm_insert_front(bench::state &st) {
+  V<T> v = filled<V, T>(st.size);
+  T value = make<T>(0);
+  st.ops_per_iteration = shifts;
+  while (st.keep_running()) {
+    for (size_t i = 0; i < shifts; i++)
+      v.insert(v.begin(), value);
+    st.pause_timing();
+    for (size_t i = 0; i < shifts; i++)
+      v.pop_back();
+    st.resume_timing();
+  }
+}
+
+template <template <typename> class V, typename T>
+void bm_insert_middle(bench::state &st) {
+  V<T> v = filled<V, T>(st.size);
+  T value = make<T>(0);
+  st.ops_per_iteration = shifts;
+  while (st.keep_running()) {
+    for (size_t i = 0; i < shifts; i++)
+      v.insert(v.begin() + v.size() / 2, value);
+    st.pause_timing();
+    for (size_t i = 0; i < shifts; i++)
+      v.pop_back();
+    st.resume_timing();
+  }
+}
+
+template <template <typename> class V, typename T>
+void bm_erase_front(bench::state &st) {
+  V<T> v = filled<V, T>(st.size + shifts);
+  st.ops_per_iteration = shifts;
+  while (st.keep_running()) {
+    for (size_t i = 0; i < shifts; i++)
+      v.erase(v.begin());
+    st.pause_timing();
+    for (size_t i = 0; i < shifts; i++)
+      v.push_back(make<T>(i));
+    st.resume_timing();
+  }
+}
+
+// for a copy-only T, sjtu::vector copies into a new buffer to keep the
+// strong guarantee, where std::vector shifts in place
+template <template <typename> class V, typename T>
+void bm_erase_middle(bench::state &st) {
+  V<T> v = filled<V, T>(st.size + shifts);
+  st.ops_per_iteration = shifts;
+  while (st.keep_running()) {
+    for (size_t i = 0; i < shifts; i++)
+      v.erase(v.begin() + v.size() / 2);
+    st.pause_timing();
+    for (size_t i = 0; i < shifts; i++)
+      v.push_back(make<T>(i));
+    st.resume_timing();
+  }
+}
+
+template <template <typename> class V, typename T>
+void bm_iterate(bench::state &st) {
+  V<T> v = filled<V, T>(st.size);
+  st.ops_per_iteration = st.size;
+  while (st.keep_running()) {
+    for (auto it = v.begin(); it != v.end(); ++it)
+      bench::do_not_optimize(*it);
+    bench::clobber_memory();
+  }
+}
+
+template <template <typename> class V, typename T>
+void bm_copy_assign(bench::state &st) {
+  V<T> src = filled<V, T>(st.size);
+  V<T> dst = filled<V, T>(st.size);
+  st.ops_per_iteration = st.size;
+  while (st.keep_running()) {
+    dst = src;
+    bench::do_not_optimize(dst.size());
+  }
+}
+
+// one growth of a full vector: every element is relocated once
+template <template <typename> class V, typename T>
+void bm_reallocate(bench::state &st) {
+  st.ops_per_iteration = st.size;
+  while (st.keep_running()) {
+    st.pause_timing();
+    V<T> v = filled<V, T>(st.size);
+    v.shrink_to_fit();
+    st.resume_timing();
+    v.reserve(st.size * 2);
+    bench::do_not_optimize(v.size());
+    st.pause_timing();
+    { V<T> drop(std::move(v)); }
+    st.resume_timing();
+  }
+}
+
+template <template <typename> class V, typename T>
+void add_all(const std::string &container, const std::string &type,
+             size_t max_size) {
+  std::vector<size_t> sizes = bench::range(8, max_size);
+  std::string suffix = "<" + container + ", " + type + ">";
+  bench::add("push_back" + suffix, bm_push_back<V, T>, sizes);
+  bench::add("insert_front" + suffix, bm_insert_front<V, T>, sizes);
+  bench::add("insert_middle" + suffix, bm_insert_middle<V, T>, sizes);
+  bench::add("erase_front" + suffix, bm_erase_front<V, T>, sizes);
+  bench::add("erase_middle" + suffix, bm_erase_middle<V, T>, sizes);
+  bench::add("iterate" + suffix, bm_iterate<V, T>, sizes);
+  bench::add("copy_assign" + suffix, bm_copy_assign<V, T>, sizes);
+  bench::add("reallocate" + suffix, bm_reallocate<V, T>, sizes);
+}
+
+// an operation on a Matrix or a Bint costs far more than on a scalar: even
+// moving a Matrix allocates its three heap blocks anew, and copying a Bint
+// goes through _SafeNewSpace. Their sweeps stop at 2^18 to keep a run short.
+template <typename T>
+void add_type(const std::string &type, size_t max_size) {
+  add_all<sjtu_vector, T>("sjtu", type, max_size);
+  add_all<std_vector, T>("std", type, max_size);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  add_type<long long>("long long", (size_t)1 << 24);
+  add_type<Integer>("Integer", (size_t)1 << 24);
+  add_type<Diamond::Matrix<double>>("Matrix<double>", (size_t)1 << 18);
+  add_type<Util::Bint>("Bint", (size_t)1 << 18);
+  return bench::run_all(argc, argv);
+}
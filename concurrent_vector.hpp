@@ -0,0 +1,349 @@
+#ifndef SJTU_CONCURRENT_VECTOR_HPP
+#define SJTU_CONCURRENT_VECTOR_HPP
+
+#include "exceptions.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+// An append-only vector that many threads may push to at once without a
+// lock. Storage is a list of segments: segment 0 holds first_segment
+// elements and each later one as many as all before it, so growing never
+// moves an element and references stay valid until the vector dies.
+//
+// push_back/emplace_back claim a slot with one compare-exchange and build
+// the element in place. size() only counts the elements that are fully
+// built, always a prefix, so any thread may read [0, size()) while others
+// append. If a constructor throws, its slot is left as a hole that at()
+// reports with runtime_error; clear() and destruction skip it.
+// clear() and the destructor must not race with anything.
+template <typename T> class concurrent_vector {
+  static constexpr size_t first_shift = 3;
+  static constexpr size_t first_segment = (size_t)1 << first_shift;
+  static constexpr size_t max_segments = sizeof(size_t) * 8 - first_shift;
+
+  enum : unsigned char { empty_slot, built, broken };
+
+  struct cell {
+    std::atomic<unsigned char> state{empty_slot};
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T *get() { return reinterpret_cast<T *>(storage); }
+    const T *get() const { return reinterpret_cast<const T *>(storage); }
+  };
+
+  std::atomic<cell *> segments[max_segments] = {};
+  std::atomic<size_t> claimed{0};
+  std::atomic<size_t> _size{0};
+
+  // one more than the index of the highest set bit of i / first_segment
+  static size_t segment_of(size_t i) {
+    size_t blocks = i >> first_shift;
+    return blocks ? sizeof(unsigned long long) * 8 -
+                        __builtin_clzll((unsigned long long)blocks)
+                  : 0;
+  }
+  static size_t segment_base(size_t k) {
+    return k == 0 ? 0 : first_segment << (k - 1);
+  }
+  static size_t segment_size(size_t k) {
+    return k == 0 ? first_segment : first_segment << (k - 1);
+  }
+
+  // the segment, allocating it if nobody has yet; racing allocators agree
+  // on one winner
+  cell *segment(size_t k) {
+    cell *s = segments[k].load(std::memory_order_acquire);
+    if (s)
+      return s;
+    cell *fresh = new cell[segment_size(k)];
+    if (segments[k].compare_exchange_strong(s, fresh,
+                                            std::memory_order_acq_rel))
+      return fresh;
+    delete[] fresh;
+    return s;
+  }
+
+  cell &slot(size_t i) const {
+    size_t k = segment_of(i);
+    return segments[k].load(std::memory_order_acquire)[i - segment_base(k)];
+  }
+
+  // moves size() past every finished slot that directly follows it. Each
+  // finisher tries after marking its slot, so the last one of a run of
+  // finished slots always gets through; that needs the mark and the loads
+  // here to stay sequentially consistent.
+  void publish() {
+    size_t n = _size.load();
+    while (n < claimed.load()) {
+      size_t k = segment_of(n);
+      cell *s = segments[k].load(std::memory_order_acquire);
+      if (s == nullptr || s[n - segment_base(k)].state.load() == empty_slot)
+        return;
+      _size.compare_exchange_weak(n, n + 1);
+    }
+  }
+
+public:
+  class const_iterator;
+  class iterator {
+    friend class concurrent_vector;
+    friend class const_iterator;
+
+  private:
+    concurrent_vector *vect;
+    size_t pos;
+
+    iterator(concurrent_vector *v, size_t p) : vect(v), pos(p) {}
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    iterator() = default;
+
+    iterator operator+(const difference_type &n) const {
+      return iterator(vect, pos + n);
+    }
+    friend iterator operator+(const difference_type &n, const iterator &it) {
+      return it + n;
+    }
+    iterator operator-(const difference_type &n) const {
+      return iterator(vect, pos - n);
+    }
+
+    difference_type operator-(const iterator &rhs) const {
+      if (vect != rhs.vect)
+        throw invalid_iterator();
+      return (difference_type)pos - (difference_type)rhs.pos;
+    }
+
+    iterator &operator+=(const difference_type &n) {
+      pos += n;
+      return *this;
+    }
+    iterator &operator-=(const difference_type &n) {
+      pos -= n;
+      return *this;
+    }
+
+    iterator &operator++() { return *this += 1; }
+    iterator operator++(int) {
+      iterator it = *this;
+      ++pos;
+      return it;
+    }
+
+    iterator &operator--() { return *this -= 1; }
+    iterator operator--(int) {
+      iterator it = *this;
+      --pos;
+      return it;
+    }
+
+    T &operator*() const { return (*vect)[pos]; }
+    T *operator->() const { return &(*vect)[pos]; }
+    T &operator[](const difference_type &n) const { return (*vect)[pos + n]; }
+
+    bool operator==(const iterator &rhs) const {
+      return vect == rhs.vect && pos == rhs.pos;
+    }
+    bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
+    bool operator<(const iterator &rhs) const { return pos < rhs.pos; }
+    bool operator>(const iterator &rhs) const { return rhs < *this; }
+    bool operator<=(const iterator &rhs) const { return !(rhs < *this); }
+    bool operator>=(const iterator &rhs) const { return !(*this < rhs); }
+  };
+  class const_iterator {
+    friend class concurrent_vector;
+
+  private:
+    const concurrent_vector *vect;
+    size_t pos;
+
+    const_iterator(const concurrent_vector *v, size_t p) : vect(v), pos(p) {}
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    const_iterator() = default;
+    const_iterator(const iterator &it) : vect(it.vect), pos(it.pos) {}
+
+    const_iterator operator+(const difference_type &n) const {
+      return const_iterator(vect, pos + n);
+    }
+    friend const_iterator operator+(const difference_type &n,
+                                    const const_iterator &it) {
+      return it + n;
+    }
+    const_iterator operator-(const difference_type &n) const {
+      return const_iterator(vect, pos - n);
+    }
+
+    difference_type operator-(const const_iterator &rhs) const {
+      if (vect != rhs.vect)
+        throw invalid_iterator();
+      return (difference_type)pos - (difference_type)rhs.pos;
+    }
+
+    const_iterator &operator+=(const difference_type &n) {
+      pos += n;
+      return *this;
+    }
+    const_iterator &operator-=(const difference_type &n) {
+      pos -= n;
+      return *this;
+    }
+
+    const_iterator &operator++() { return *this += 1; }
+    const_iterator operator++(int) {
+      const_iterator it = *this;
+      ++pos;
+      return it;
+    }
+
+    const_iterator &operator--() { return *this -= 1; }
+    const_iterator operator--(int) {
+      const_iterator it = *this;
+      --pos;
+      return it;
+    }
+
+    const T &operator*() const { return (*vect)[pos]; }
+    const T *operator->() const { return &(*vect)[pos]; }
+    const T &operator[](const difference_type &n) const {
+      return (*vect)[pos + n];
+    }
+
+    bool operator==(const const_iterator &rhs) const {
+      return vect == rhs.vect && pos == rhs.pos;
+    }
+    bool operator!=(const const_iterator &rhs) const {
+      return !(*this == rhs);
+    }
+    bool operator<(const const_iterator &rhs) const { return pos < rhs.pos; }
+    bool operator>(const const_iterator &rhs) const { return rhs < *this; }
+    bool operator<=(const const_iterator &rhs) const {
+      return !(rhs < *this);
+    }
+    bool operator>=(const const_iterator &rhs) const {
+      return !(*this < rhs);
+    }
+  };
+
+  concurrent_vector() = default;
+  concurrent_vector(const concurrent_vector &) = delete;
+  concurrent_vector &operator=(const concurrent_vector &) = delete;
+  ~concurrent_vector() {
+    clear();
+    for (size_t k = 0; k < max_segments; k++)
+      delete[] segments[k].load();
+  }
+
+  // the element must be built, i.e. pos < size()
+  T &operator[](const size_t &pos) { return *slot(pos).get(); }
+  const T &operator[](const size_t &pos) const { return *slot(pos).get(); }
+
+  T &at(const size_t &pos) {
+    if (pos >= size())
+      throw index_out_of_bound();
+    cell &c = slot(pos);
+    if (c.state.load(std::memory_order_acquire) != built)
+      throw runtime_error();
+    return *c.get();
+  }
+  const T &at(const size_t &pos) const {
+    return const_cast<concurrent_vector *>(this)->at(pos);
+  }
+
+  const T &front() const {
+    if (empty())
+      throw container_is_empty();
+    return at(0);
+  }
+
+  const T &back() const {
+    if (empty())
+      throw container_is_empty();
+    return at(size() - 1);
+  }
+
+  iterator begin() { return iterator(this, 0); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator cbegin() const { return const_iterator(this, 0); }
+
+  // a snapshot: elements appended later are not in [begin(), end())
+  iterator end() { return iterator(this, size()); }
+  const_iterator end() const { return const_iterator(this, size()); }
+  const_iterator cend() const { return const_iterator(this, size()); }
+
+  bool empty() const { return size() == 0; }
+
+  size_t size() const { return _size.load(std::memory_order_acquire); }
+
+  // allocates the segments for the first n elements ahead of time
+  void reserve(size_t n) {
+    for (size_t k = 0; k < max_segments && segment_base(k) < n; k++)
+      segment(k);
+  }
+
+  // destroys every element but keeps the segments; not thread-safe
+  void clear() {
+    size_t n = claimed.load();
+    for (size_t i = 0; i < n; i++) {
+      cell &c = slot(i);
+      if (c.state.load() == built)
+        c.get()->~T();
+      c.state.store(empty_slot);
+    }
+    claimed.store(0);
+    _size.store(0);
+  }
+
+  // safe to call from any number of threads at once; returns a reference
+  // that stays valid until the vector is cleared or destroyed
+  template <typename... Args> T &emplace_back(Args &&...args) {
+    // the segment is allocated before the slot is claimed, so a failed
+    // allocation leaves nothing behind
+    size_t i = claimed.load(std::memory_order_relaxed), k;
+    cell *s;
+    do {
+      k = segment_of(i);
+      s = segment(k);
+    } while (!claimed.compare_exchange_weak(i, i + 1,
+                                            std::memory_order_relaxed));
+    cell &c = s[i - segment_base(k)];
+    try {
+      new (c.get()) T(std::forward<Args>(args)...);
+    } catch (...) {
+      c.state.store(broken);
+      publish();
+      throw;
+    }
+    // the next slot in line publishes itself with one compare-exchange;
+    // otherwise the mark has to be sequentially consistent, see publish()
+    c.state.store(built, std::memory_order_release);
+    size_t expected = i;
+    if (!_size.compare_exchange_strong(expected, i + 1))
+      c.state.store(built);
+    publish();
+    return *c.get();
+  }
+
+  void push_back(const T &value) { emplace_back(value); }
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+};
+} // namespace sjtu
+
+#endif
@@ -2,28 +2,138 @@
 #include <iostream>
 #include <cstring>
 #include <cstdlib>
+#include <cstdint>
 #include <vector>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(BINT_NO_AVX2)
+#include <immintrin.h>
+// the NTT multiplier gets AVX2 butterflies, taken when the CPU has AVX2
+#define BINT_NTT_AVX2
+#endif
 
 namespace Util {
 
-const size_t MIN_CAPACITY = 2048;
+// magnitudes are stored in base 2^32, least significant limb first
+typedef std::uint32_t Limb;
+typedef std::uint64_t DoubleLimb;
+
+// limbs kept inside the object itself, enough for any long long
+const size_t INLINE_CAPACITY = 2;
+
+// operand sizes, in limbs, from which operator* switches to Karatsuba and
+// to Toom-3; tuned with bench/bench_bint.cpp
+const size_t KARATSUBA_THRESHOLD = 32;
+const size_t KARATSUBA_SQR_THRESHOLD = 48;
+const size_t TOOM3_THRESHOLD = 500;
+
+// the NTT multiplier works modulo three primes c 2^k + 1 below 2^30, with 3
+// generating each multiplicative group. Their product exceeds 2^22 2^64, so
+// every coefficient of a product of at most NTT_MAX_LENGTH limbs comes back
+// exact; 2^23 is also the longest transform the first prime allows.
+const Limb NTT_PRIMES[3] = {998244353, 167772161, 469762049};
+const Limb NTT_GENERATOR = 3;
+const size_t NTT_MAX_LENGTH = size_t(1) << 23;
+// shorter operand, in limbs, from which operator* uses the NTT
+const size_t NTT_THRESHOLD = 1000;
+// transforms longer than this many limbs are split in halves until they
+// fit in cache
+const size_t NTT_BLOCK = size_t(1) << 12;
+
+// divisor length, in limbs, from which division is recursive
+// (Burnikel-Ziegler) rather than schoolbook (Knuth's algorithm D), as long
+// as the quotient is about as long
+const size_t BZ_THRESHOLD = 100;
+// odd moduli below this many limbs take Montgomery multiplication in
+// powmod; longer ones, and even ones, reduce by division
+const size_t REDC_THRESHOLD = 256;
+// numbers shorter than this many limbs are converted to and from decimal
+// nine digits at a time; longer ones are split at powers of 10^9
+const size_t DECIMAL_THRESHOLD = 40;
 
 class Bint {
-	class NewSpaceFailed : public std::runtime_error {
-	public:
-		NewSpaceFailed();
-	};
 	class BadCast : public std::invalid_argument {
 	public:
 		BadCast();
 	};
+	class DivisionByZero : public std::domain_error {
+	public:
+		DivisionByZero();
+	};
+	class NegativeExponent : public std::domain_error {
+	public:
+		NegativeExponent();
+	};
 	bool isMinus = false;
-	size_t length;
-	int *data = nullptr;
-	size_t capacity = MIN_CAPACITY;
-	void _DoubleSpace();
-	void _SafeNewSpace(int *&p, const size_t &len);
+	size_t length = 1;
+	// more than INLINE_CAPACITY means the limbs live in `heap`
+	size_t capacity = INLINE_CAPACITY;
+	union {
+		Limb *heap;
+		Limb small[INLINE_CAPACITY];
+	};
+	Limb *data() { return capacity > INLINE_CAPACITY ? heap : small; }
+	const Limb *data() const { return capacity > INLINE_CAPACITY ? heap : small; }
+	void _SafeNewSpace(const size_t &len);
+	void _Release();
+	void _Steal(Bint &b);
+	void _Assign(unsigned long long x, bool minus);
+	void _Trim();
+	Limb _DivSmall(Limb divisor);
+	static int _CompareAbs(const Bint &lhs, const Bint &rhs);
+	static Bint _AddAbs(const Bint &lhs, const Bint &rhs);
+	static Bint _SubAbs(const Bint &lhs, const Bint &rhs);
+	static Bint _Add(const Bint &lhs, const Bint &rhs, bool rhsMinus);
+	static Limb _AddN(Limb *r, const Limb *a, size_t n, const Limb *b, size_t m);
+	static Limb _SubN(Limb *r, const Limb *a, size_t n, const Limb *b, size_t m);
+	static bool _AbsDiff(Limb *r, const Limb *a, size_t n, const Limb *b, size_t m);
+	static size_t _MulScratch(size_t n);
+	static void _MulBasecase(Limb *r, const Limb *x, size_t n, const Limb *y, size_t m);
+	static void _SqrBasecase(Limb *r, const Limb *x, size_t n);
+	static void _MulKaratsuba(Limb *r, const Limb *x, size_t n, const Limb *y, size_t m, Limb *scratch);
+	static void _SqrKaratsuba(Limb *r, const Limb *x, size_t n, Limb *scratch);
+	static Bint _Slice(const Bint &b, size_t from, size_t len);
+	static Bint _Toom3(const Bint &lhs, const Bint &rhs, size_t k);
+	// Montgomery constants of one NTT prime, with R = 2^32
+	struct NttPrime {
+		Limb p;
+		Limb pinv; // -p^-1 mod R
+		Limb r2; // R^2 mod p
+	};
+	static const NttPrime &_NttPrime(size_t i);
+	static bool _NttAvx2();
+	static Limb _NttPow(Limb base, DoubleLimb e, Limb p);
+	static Limb _MontMul(Limb a, Limb b, const NttPrime &q);
+	static void _NttRoots(Limb *w, size_t n, Limb root, const NttPrime &q);
+	static void _NttLevel(Limb *a, size_t n, size_t h, const Limb *w, const NttPrime &q, bool forward, bool avx2);
+	static void _NttForward(Limb *a, size_t n, const Limb *w, const NttPrime &q, bool avx2);
+	static void _NttInverse(Limb *a, size_t n, const Limb *w, const NttPrime &q, bool avx2);
+	static void _NttPointwise(Limb *a, const Limb *b, size_t n, Limb scale, const NttPrime &q, bool avx2);
+#ifdef BINT_NTT_AVX2
+	static void _NttLevelAvx2(Limb *a, size_t n, size_t h, const Limb *w, const NttPrime &q, bool forward);
+	static void _NttPointwiseAvx2(Limb *a, const Limb *b, size_t n, Limb scale, const NttPrime &q);
+	static __m256i _MontMul8(__m256i a, __m256i b, __m256i p, __m256i pinv);
+#endif
+	static Bint _MulNtt(const Bint &a, const Bint &b, bool square);
+	static Bint _MulAbs(const Bint &lhs, const Bint &rhs);
+	bool _IsZero() const;
+	size_t _BitLength() const;
+	static Limb _LimbInverse(Limb x);
+	static Bint _ShiftLeft(const Bint &b, size_t bits);
+	static Bint _ShiftRight(const Bint &b, size_t bits);
+	static Bint _Join(const Bint &high, const Bint &low, size_t k);
+	static void _DivKnuth(const Bint &a, const Bint &b, Bint &q, Bint &r);
+	static void _Div2n1n(const Bint &a, const Bint &b, size_t n, Bint &q, Bint &r);
+	static void _Div3n2n(const Bint &a, const Bint &b, size_t h, Bint &q, Bint &r);
+	static void _DivBurnikelZiegler(const Bint &a, const Bint &b, Bint &q, Bint &r);
+	static void _DivModAbs(const Bint &a, const Bint &b, Bint &q, Bint &r);
+	static Bint _MulRedc(const Bint &a, const Bint &b, const Bint &m, Limb minv, std::vector<Limb> &t);
+	static Bint _PowMod(const Bint &base, const Bint &exponent, const Bint &m);
+	static std::vector<Bint> _DecimalPowers(size_t digits);
+	static Bint _FromDecimal(const char *s, size_t n, const std::vector<Bint> &pow);
+	static void _ToDecimal(const Bint &x, const std::vector<Bint> &pow, size_t k, size_t width, std::string &out);
 	explicit Bint(const size_t &capa);
 public:
 	Bint();
@@ -53,6 +163,10 @@ public:
 	friend Bint operator-(Bint &&b);
 	friend Bint operator-(const Bint &lhs, const Bint &rhs);
 	friend Bint operator*(const Bint &lhs, const Bint &rhs);
+	friend Bint operator/(const Bint &lhs, const Bint &rhs);
+	friend Bint operator%(const Bint &lhs, const Bint &rhs);
+	friend std::pair<Bint, Bint> divmod(const Bint &lhs, const Bint &rhs);
+	friend Bint powmod(const Bint &base, const Bint &exponent, const Bint &modulus);
 
 	friend std::istream &operator>>(std::istream &is, Bint &b);
 	friend std::ostream &operator<<(std::ostream &os, const Bint &b);
@@ -61,196 +175,277 @@ public:
 };
 }
 
-#include <iomanip>
+namespace sjtu {
+template <typename T> struct is_trivially_relocatable;
+// Bint keeps small values inline and otherwise only owns `heap`; nothing
+// points into the object, so moving its bytes is a valid relocation.
+template <> struct is_trivially_relocatable<Util::Bint> : std::true_type {};
+}
+
 #include <algorithm>
 
 namespace Util {
 
-Bint::NewSpaceFailed::NewSpaceFailed() : std::runtime_error("No Enough Memory Space.") {}
 Bint::BadCast::BadCast() : std::invalid_argument("Cannot convert to a Bint object") {}
+Bint::DivisionByZero::DivisionByZero() : std::domain_error("Division by zero.") {}
+Bint::NegativeExponent::NegativeExponent() : std::domain_error("Negative exponent.") {}
 
-void Bint::_SafeNewSpace(int *&p, const size_t &len)
+// drops the current limbs and makes room for exactly `len` of them, inline
+// when they fit; if the allocation throws, the old limbs are kept
+void Bint::_SafeNewSpace(const size_t &len)
 {
-	if (p != nullptr) {
-		delete[] p;
-		p = nullptr;
+	if (len > INLINE_CAPACITY) {
+		Limb *fresh = new Limb[len];
+		_Release();
+		heap = fresh;
+		capacity = len;
+	} else {
+		_Release();
 	}
-	p = new int[len];
-	if (p == nullptr) {
-		throw NewSpaceFailed();
+}
+
+void Bint::_Release()
+{
+	if (capacity > INLINE_CAPACITY) {
+		delete[] heap;
+		capacity = INLINE_CAPACITY;
 	}
-	memset(p, 0, len * sizeof(unsigned int));
 }
 
-void Bint::_DoubleSpace()
+// takes b's limbs and leaves b as an inline zero
+void Bint::_Steal(Bint &b)
 {
-	int *newMem = nullptr;
-	_SafeNewSpace(newMem, capacity << 1);
-	memcpy(newMem, data, capacity * sizeof(int));
-	delete[] data;
-	data = newMem;
-	capacity <<= 1;
+	isMinus = b.isMinus;
+	length = b.length;
+	capacity = b.capacity;
+	if (capacity > INLINE_CAPACITY) {
+		heap = b.heap;
+	} else {
+		memcpy(small, b.small, sizeof(Limb) * length);
+	}
+	b.isMinus = false;
+	b.length = 1;
+	b.capacity = INLINE_CAPACITY;
+	b.small[0] = 0;
 }
 
-Bint::Bint()
-	: length(1)
+void Bint::_Assign(unsigned long long x, bool minus)
 {
-	_SafeNewSpace(data, capacity);
+	Limb *d = data();
+	isMinus = minus;
+	d[0] = static_cast<Limb>(x);
+	d[1] = static_cast<Limb>(x >> 32);
+	length = d[1] ? 2 : 1;
+	_Trim();
 }
 
-Bint::Bint(int x)
-	: length(0)
+// drops leading zero limbs; zero is never negative
+void Bint::_Trim()
 {
-	_SafeNewSpace(data, capacity);
-	if (x < 0) {
-		isMinus = true;
-		x = -x;
+	const Limb *d = data();
+	while (length > 1 && d[length - 1] == 0) {
+		--length;
 	}
-	while (x) {
-		data[length++] = x % 10000;
-		x /= 10000;
+	if (length == 1 && d[0] == 0) {
+		isMinus = false;
 	}
-	if (!length) {
-		length = 1;
+}
+
+// divides the magnitude by `divisor` in place and returns the remainder
+Limb Bint::_DivSmall(Limb divisor)
+{
+	Limb *d = data();
+	DoubleLimb rem = 0;
+	for (size_t i = length; i-- > 0; ) {
+		DoubleLimb cur = rem << 32 | d[i];
+		d[i] = static_cast<Limb>(cur / divisor);
+		rem = cur % divisor;
 	}
+	_Trim();
+	return static_cast<Limb>(rem);
+}
+
+Bint::Bint()
+{
+	small[0] = 0;
+}
+
+Bint::Bint(int x)
+{
+	_Assign(x < 0 ? 0ULL - static_cast<unsigned long long>(x) : x, x < 0);
 }
 
 Bint::Bint(long long x)
-	: length(0)
 {
-	_SafeNewSpace(data, capacity);
-	if (x < 0) {
-		isMinus = true;
-		x = -x;
-	}
-	while (x) {
-		data[length++] = static_cast<unsigned int>(x % 10000);
-		x /= 10000;
-	}
-	if (!length) {
-		length = 1;
-	}
+	_Assign(x < 0 ? 0ULL - static_cast<unsigned long long>(x) : x, x < 0);
 }
 
+// zero with room for `capa` zeroed limbs
 Bint::Bint(const size_t &capa)
-	: length(1)
 {
-	while (capacity < capa) {
-		capacity <<= 1;
+	_SafeNewSpace(capa);
+	memset(data(), 0, sizeof(Limb) * std::max(capa, (size_t)1));
+}
+
+// 10^9, 10^18, 10^36, ...: the powers 10^(9 2^k) for every k with
+// 9 2^k < digits
+std::vector<Bint> Bint::_DecimalPowers(size_t digits)
+{
+	std::vector<Bint> pow(1, Bint(1000000000));
+	for (size_t k = 1; (size_t(9) << k) < digits; ++k) {
+		pow.push_back(pow.back() * pow.back());
 	}
-	_SafeNewSpace(data, capacity);
+	return pow;
 }
 
-Bint::Bint(std::string x)
+// the value of the n decimal digits at s. Short runs are read nine digits
+// at a time: multiply by 10^k and add them in. Longer ones split off their
+// low 9 2^k digits and join the halves as high * 10^(9 2^k) + low, so the
+// cost follows that of operator*.
+Bint Bint::_FromDecimal(const char *s, size_t n, const std::vector<Bint> &pow)
 {
-	while (x[0] == '-') {
-		isMinus = !isMinus;
-		x.erase(0, 1);
+	if (n <= 9 * DECIMAL_THRESHOLD) {
+		// every nine digits need less than one 32-bit limb
+		Bint result(n / 9 + 1);
+		Limb *d = result.data();
+		for (size_t i = 0; i < n; ) {
+			size_t end = std::min(n, i + 9);
+			Limb chunk = 0, scale = 1;
+			for (; i < end; ++i) {
+				chunk = chunk * 10 + (s[i] - '0');
+				scale *= 10;
+			}
+			DoubleLimb carry = chunk;
+			for (size_t j = 0; j < result.length; ++j) {
+				carry += static_cast<DoubleLimb>(d[j]) * scale;
+				d[j] = static_cast<Limb>(carry);
+				carry >>= 32;
+			}
+			if (carry) {
+				d[result.length++] = static_cast<Limb>(carry);
+			}
+		}
+		result._Trim();
+		return result;
 	}
-	while ((capacity << 2) <= x.length()) {
-		capacity <<= 1;
+	size_t k = 0;
+	while ((size_t(18) << k) < n) {
+		++k;
 	}
+	size_t low = size_t(9) << k;
+	return _FromDecimal(s, n - low, pow) * pow[k] + _FromDecimal(s + n - low, low, pow);
+}
 
-	_SafeNewSpace(data, capacity);
-
-	size_t mid = x.length() >> 1;
-	for (size_t i = 0; i < mid; ++i) {
-		std::swap(x[i], x[x.length() - 1 - i]);
+// appends the digits of x >= 0, which is below 10^(9 2^(k + 1)), to out,
+// zero-padded to `width` digits unless width is 0. Long values are split
+// by the divmod with pow[k] and each half printed recursively.
+void Bint::_ToDecimal(const Bint &x, const std::vector<Bint> &pow, size_t k, size_t width, std::string &out)
+{
+	if (k == 0 || x.length <= DECIMAL_THRESHOLD) {
+		// peels off base-10^9 chunks from a copy, least significant first
+		Bint rest(x);
+		std::string digits;
+		do {
+			Limb chunk = rest._DivSmall(1000000000);
+			for (int i = 0; i < 9; ++i) {
+				digits += static_cast<char>('0' + chunk % 10);
+				chunk /= 10;
+			}
+		} while (!rest._IsZero());
+		while (digits.length() > 1 && digits.back() == '0') {
+			digits.pop_back();
+		}
+		if (width > digits.length()) {
+			digits.append(width - digits.length(), '0');
+		}
+		out.append(digits.rbegin(), digits.rend());
+		return;
+	}
+	Bint q, r;
+	_DivModAbs(x, pow[k], q, r);
+	size_t low = size_t(9) << k;
+	if (width > 0) {
+		_ToDecimal(q, pow, k - 1, width - low, out);
+	} else if (!q._IsZero()) {
+		_ToDecimal(q, pow, k - 1, 0, out);
+	} else {
+		_ToDecimal(r, pow, k - 1, 0, out);
+		return;
 	}
+	_ToDecimal(r, pow, k - 1, low, out);
+}
 
-	const static unsigned int pow10[4] = {1, 10, 100, 1000};
-	for (size_t i = 0; i < capacity; ++i) {
-		if ((i << 2) >= x.length()) {
-			length = i;
-			break;
-		}
-		for (size_t j = 0; j < 4; ++j) {
-			if ((i << 2) + j >= x.length()) {
-				break;
-			}
-			if (x[(i << 2) + j] > '9' || x[(i << 2) + j] < '0') {
-				throw BadCast();
-			}
-			data[i] = data[i] + (x[(i << 2) + j] - '0') * pow10[j];
+Bint::Bint(std::string x)
+{
+	size_t start = 0;
+	bool minus = false;
+	while (start < x.length() && x[start] == '-') {
+		minus = !minus;
+		++start;
+	}
+	for (size_t i = start; i < x.length(); ++i) {
+		if (x[i] > '9' || x[i] < '0') {
+			throw BadCast();
 		}
 	}
+	size_t n = x.length() - start;
+	std::vector<Bint> pow;
+	if (n > 9 * DECIMAL_THRESHOLD) {
+		pow = _DecimalPowers(n);
+	}
+	Bint value = _FromDecimal(x.data() + start, n, pow);
+	_Steal(value);
+	isMinus = minus;
+	_Trim();
 }
 
 Bint::Bint(const Bint &b)
-	: isMinus(b.isMinus), length(b.length), capacity(b.capacity)
+	: isMinus(b.isMinus), length(b.length)
 {
-	_SafeNewSpace(data, capacity);
-	memcpy(data, b.data, sizeof(unsigned int) * capacity);
+	_SafeNewSpace(length);
+	memcpy(data(), b.data(), sizeof(Limb) * length);
 }
 
 Bint::Bint(Bint &&b) noexcept
-	: isMinus(b.isMinus), length(b.length), capacity(b.capacity)
 {
-	data = b.data;
-	b.data = nullptr;
+	_Steal(b);
 }
 
 Bint &Bint::operator=(int x)
 {
-	memset(data, 0, sizeof(unsigned int) * capacity);
-	length = 0;
-	if (x < 0) {
-		isMinus = true;
-		x = -x;
-	}
-	while (x) {
-		data[length++] = x % 10000;
-		x /= 10000;
-	}
-	if (!length) {
-		length = 1;
-	}
+	_Assign(x < 0 ? 0ULL - static_cast<unsigned long long>(x) : x, x < 0);
 	return *this;
 }
 
 Bint &Bint::operator=(long long x)
 {
-	memset(data, 0, sizeof(unsigned int) * capacity);
-	length = 0;
-	if (x < 0) {
-		isMinus = true;
-		x = -x;
-	}
-	while (x) {
-		data[length++] = static_cast<unsigned int>(x % 10000);
-		x /= 10000;
-	}
-	if (!length) {
-		length = 1;
-	}
+	_Assign(x < 0 ? 0ULL - static_cast<unsigned long long>(x) : x, x < 0);
 	return *this;
 }
 
+// reuses the current buffer whenever rhs fits in it
 Bint &Bint::operator=(const Bint &rhs)
 {
 	if (this == &rhs) {
 		return *this;
 	}
-	if (rhs.capacity > capacity) {
-		capacity = rhs.capacity;
-		_SafeNewSpace(data, capacity);
+	if (rhs.length > capacity) {
+		_SafeNewSpace(rhs.length);
 	}
-	memcpy(data, rhs.data, sizeof(unsigned int) * rhs.capacity);
+	memcpy(data(), rhs.data(), sizeof(Limb) * rhs.length);
 	length = rhs.length;
 	isMinus = rhs.isMinus;
 	return *this;
 }
 
+// frees our own buffer before taking rhs's, which would otherwise leak
 Bint &Bint::operator=(Bint &&rhs) noexcept
 {
 	if (this == &rhs) {
 		return *this;
 	}
-	capacity = rhs.capacity;
-	length = rhs.length;
-	isMinus = rhs.isMinus;
-	data = rhs.data;
-	rhs.data = nullptr;
+	_Release();
+	_Steal(rhs);
 	return *this;
 }
 
@@ -262,19 +457,19 @@ std::istream &operator>>(std::istream &is, Bint &b)
 	return is;
 }
 
+// a value of n limbs has fewer than 10 n decimal digits
 std::ostream &operator<<(std::ostream &os, const Bint &b)
 {
-	if (b.data == nullptr) {
-		return os;
+	std::vector<Bint> pow;
+	if (b.length > DECIMAL_THRESHOLD) {
+		pow = Bint::_DecimalPowers(10 * b.length);
 	}
-	if (b.isMinus && (b.length > 1 || b.data[0] != 0)) {
-		os << "-";
+	std::string out;
+	if (b.isMinus) {
+		out += '-';
 	}
-	os << b.data[b.length - 1];
-	for (long long i = b.length - 2LL; i >= 0; --i) {
-		os << std::setw(4) << std::setfill('0') << b.data[i];
-	}
-	return os;
+	Bint::_ToDecimal(abs(b), pow, pow.empty() ? 0 : pow.size() - 1, 0, out);
+	return os << out;
 }
 
 Bint abs(const Bint &b)
@@ -287,7 +482,7 @@ Bint abs(const Bint &b)
 Bint abs(Bint &&b)
 {
 	b.isMinus = false;
-	return b;
+	return std::move(b);
 }
 
 bool operator==(const Bint &lhs, const Bint &rhs)
@@ -299,7 +494,7 @@ bool operator==(const Bint &lhs, const Bint &rhs)
 		return false;
 	}
 	for (size_t i = 0; i < lhs.length; ++i) {
-		if (lhs.data[i] != rhs.data[i]) {
+		if (lhs.data()[i] != rhs.data()[i]) {
 			return false;
 		}
 	}
@@ -315,7 +510,7 @@ bool operator!=(const Bint &lhs, const Bint &rhs)
 		return true;
 	}
 	for (size_t i = 0; i < lhs.length; ++i) {
-		if (lhs.data[i] != rhs.data[i]) {
+		if (lhs.data()[i] != rhs.data()[i]) {
 			return true;
 		}
 	}
@@ -325,15 +520,15 @@ bool operator!=(const Bint &lhs, const Bint &rhs)
 bool operator<(const Bint &lhs, const Bint &rhs)
 {
 	if (lhs.isMinus != rhs.isMinus) {
-		return !lhs.isMinus;
+		return lhs.isMinus;
 	}
 	if (lhs.isMinus) {
 		if (lhs.length != rhs.length) {
 			return lhs.length > rhs.length;
 		}
 		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] > rhs.data[i];
+			if (lhs.data()[i] != rhs.data()[i]) {
+				return lhs.data()[i] > rhs.data()[i];
 			}
 		}
 		return false;
@@ -342,8 +537,8 @@ bool operator<(const Bint &lhs, const Bint &rhs)
 			return lhs.length < rhs.length;
 		}
 		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] < rhs.data[i];
+			if (lhs.data()[i] != rhs.data()[i]) {
+				return lhs.data()[i] < rhs.data()[i];
 			}
 		}
 		return false;
@@ -358,15 +553,15 @@ bool operator>(const Bint &lhs, const Bint &rhs)
 bool operator<=(const Bint &lhs, const Bint &rhs)
 {
 	if (lhs.isMinus != rhs.isMinus) {
-		return !lhs.isMinus;
+		return lhs.isMinus;
 	}
 	if (lhs.isMinus) {
 		if (lhs.length != rhs.length) {
 			return lhs.length > rhs.length;
 		}
 		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] > rhs.data[i];
+			if (lhs.data()[i] != rhs.data()[i]) {
+				return lhs.data()[i] > rhs.data()[i];
 			}
 		}
 		return true;
@@ -375,8 +570,8 @@ bool operator<=(const Bint &lhs, const Bint &rhs)
 			return lhs.length < rhs.length;
 		}
 		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] < rhs.data[i];
+			if (lhs.data()[i] != rhs.data()[i]) {
+				return lhs.data()[i] < rhs.data()[i];
 			}
 		}
 		return true;
@@ -386,15 +581,15 @@ bool operator<=(const Bint &lhs, const Bint &rhs)
 bool operator>=(const Bint &lhs, const Bint &rhs)
 {
 	if (lhs.isMinus != rhs.isMinus) {
-		return lhs.isMinus;
+		return !lhs.isMinus;
 	}
 	if (lhs.isMinus) {
 		if (lhs.length != rhs.length) {
 			return lhs.length < rhs.length;
 		}
 		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] < rhs.data[i];
+			if (lhs.data()[i] != rhs.data()[i]) {
+				return lhs.data()[i] < rhs.data()[i];
 			}
 		}
 		return true;
@@ -403,114 +598,1042 @@ bool operator>=(const Bint &lhs, const Bint &rhs)
 			return lhs.length > rhs.length;
 		}
 		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] > rhs.data[i];
+			if (lhs.data()[i] != rhs.data()[i]) {
+				return lhs.data()[i] > rhs.data()[i];
 			}
 		}
 		return true;
 	}
 }
 
+// -1, 0 or 1 as |lhs| is less than, equal to or greater than |rhs|
+int Bint::_CompareAbs(const Bint &lhs, const Bint &rhs)
+{
+	if (lhs.length != rhs.length) {
+		return lhs.length < rhs.length ? -1 : 1;
+	}
+	const Limb *x = lhs.data(), *y = rhs.data();
+	for (size_t i = lhs.length; i-- > 0; ) {
+		if (x[i] != y[i]) {
+			return x[i] < y[i] ? -1 : 1;
+		}
+	}
+	return 0;
+}
 
-Bint operator+(const Bint &lhs, const Bint &rhs)
+// r[0, n) = a[0, n) + b[0, m) for m <= n; returns the carry out. r may be a.
+Limb Bint::_AddN(Limb *r, const Limb *a, size_t n, const Limb *b, size_t m)
 {
-	if (lhs.isMinus == rhs.isMinus) {
-		size_t maxLen = std::max(lhs.length, rhs.length);
-		size_t expectLen = maxLen + 1;
-		Bint result(expectLen); // special constructor
-		for (size_t i = 0; i < maxLen; ++i) {
-			result.data[i] = lhs.data[i] + rhs.data[i];
-		}
-		for (size_t i = 0; i < maxLen; ++i) {
-			if (result.data[i] > 10000) {
-				result.data[i] -= 10000;
-				++result.data[i + 1];
-			}
+	DoubleLimb carry = 0;
+	size_t i = 0;
+	for (; i < m; ++i) {
+		carry += static_cast<DoubleLimb>(a[i]) + b[i];
+		r[i] = static_cast<Limb>(carry);
+		carry >>= 32;
+	}
+	for (; i < n; ++i) {
+		carry += a[i];
+		r[i] = static_cast<Limb>(carry);
+		carry >>= 32;
+	}
+	return static_cast<Limb>(carry);
+}
+
+// r[0, n) = a[0, n) - b[0, m) for m <= n; returns the borrow out. r may be a.
+Limb Bint::_SubN(Limb *r, const Limb *a, size_t n, const Limb *b, size_t m)
+{
+	DoubleLimb borrow = 0;
+	size_t i = 0;
+	for (; i < m; ++i) {
+		DoubleLimb diff = static_cast<DoubleLimb>(a[i]) - b[i] - borrow;
+		r[i] = static_cast<Limb>(diff);
+		borrow = diff >> 63;
+	}
+	for (; i < n; ++i) {
+		DoubleLimb diff = static_cast<DoubleLimb>(a[i]) - borrow;
+		r[i] = static_cast<Limb>(diff);
+		borrow = diff >> 63;
+	}
+	return static_cast<Limb>(borrow);
+}
+
+// r[0, max(n, m)) = |a - b|; returns whether a < b
+bool Bint::_AbsDiff(Limb *r, const Limb *a, size_t n, const Limb *b, size_t m)
+{
+	size_t len = std::max(n, m);
+	while (n > 0 && a[n - 1] == 0) {
+		--n;
+	}
+	while (m > 0 && b[m - 1] == 0) {
+		--m;
+	}
+	bool less = n < m;
+	if (n == m) {
+		size_t i = n;
+		while (i > 0 && a[i - 1] == b[i - 1]) {
+			--i;
 		}
-		result.length = result.data[maxLen] > 0 ? maxLen + 1 : maxLen;
+		less = i > 0 && a[i - 1] < b[i - 1];
+	}
+	if (less) {
+		std::swap(a, b);
+		std::swap(n, m);
+	}
+	_SubN(r, a, n, b, m);
+	memset(r + n, 0, sizeof(Limb) * (len - n));
+	return less;
+}
+
+// |lhs| + |rhs|
+Bint Bint::_AddAbs(const Bint &lhs, const Bint &rhs)
+{
+	const Bint &longer = lhs.length >= rhs.length ? lhs : rhs;
+	const Bint &shorter = lhs.length >= rhs.length ? rhs : lhs;
+	Bint result(longer.length + 1); // special constructor
+	Limb *r = result.data();
+	r[longer.length] = _AddN(r, longer.data(), longer.length, shorter.data(), shorter.length);
+	result.length = longer.length + 1;
+	result._Trim();
+	return result;
+}
+
+// |lhs| - |rhs|, where |lhs| >= |rhs|
+Bint Bint::_SubAbs(const Bint &lhs, const Bint &rhs)
+{
+	Bint result(lhs.length);
+	_SubN(result.data(), lhs.data(), lhs.length, rhs.data(), rhs.length);
+	result.length = lhs.length;
+	result._Trim();
+	return result;
+}
+
+// lhs + rhs, with rhs taken as negative when rhsMinus is set
+Bint Bint::_Add(const Bint &lhs, const Bint &rhs, bool rhsMinus)
+{
+	Bint result;
+	if (lhs.isMinus == rhsMinus) {
+		result = _AddAbs(lhs, rhs);
+		result.isMinus = rhsMinus;
+	} else if (_CompareAbs(lhs, rhs) >= 0) {
+		result = _SubAbs(lhs, rhs);
 		result.isMinus = lhs.isMinus;
-		return result;
 	} else {
-		if (lhs.isMinus) {
-			return rhs - abs(lhs);
-		} else {
-			return lhs - abs(rhs);
-		}
+		result = _SubAbs(rhs, lhs);
+		result.isMinus = rhsMinus;
 	}
+	result._Trim();
+	return result;
+}
+
+Bint operator+(const Bint &lhs, const Bint &rhs)
+{
+	return Bint::_Add(lhs, rhs, rhs.isMinus);
 }
 
 Bint operator-(const Bint &b)
 {
 	Bint result(b);
 	result.isMinus = !result.isMinus;
+	result._Trim();
 	return result;
 }
 
 Bint operator-(Bint &&b)
 {
 	b.isMinus = !b.isMinus;
-	return b;
+	b._Trim();
+	return std::move(b);
 }
 
 Bint operator-(const Bint &lhs, const Bint &rhs)
 {
-	if (lhs.isMinus == rhs.isMinus) {
-		if (lhs.isMinus) {
-			return -(abs(lhs) - abs(rhs));
+	return Bint::_Add(lhs, rhs, !rhs.isMinus);
+}
+
+// limbs of scratch that _MulKaratsuba and _SqrKaratsuba need for n-limb
+// operands: 3n + 4 per level, each level halving n
+size_t Bint::_MulScratch(size_t n)
+{
+	size_t total = 0;
+	for (; n >= std::min(KARATSUBA_THRESHOLD, KARATSUBA_SQR_THRESHOLD); n -= n / 2) {
+		total += 3 * n + 4;
+	}
+	return total;
+}
+
+// r[0, n + m) = x[0, n) * y[0, m)
+void Bint::_MulBasecase(Limb *r, const Limb *x, size_t n, const Limb *y, size_t m)
+{
+	memset(r, 0, sizeof(Limb) * (n + m));
+	for (size_t i = 0; i < n; ++i) {
+		DoubleLimb carry = 0;
+		for (size_t j = 0; j < m; ++j) {
+			carry += static_cast<DoubleLimb>(x[i]) * y[j] + r[i + j];
+			r[i + j] = static_cast<Limb>(carry);
+			carry >>= 32;
+		}
+		r[i + m] = static_cast<Limb>(carry);
+	}
+}
+
+// r[0, 2n) = x[0, n)^2: every cross product once, doubled, plus the squares
+void Bint::_SqrBasecase(Limb *r, const Limb *x, size_t n)
+{
+	memset(r, 0, sizeof(Limb) * 2 * n);
+	for (size_t i = 0; i < n; ++i) {
+		DoubleLimb carry = 0;
+		for (size_t j = i + 1; j < n; ++j) {
+			carry += static_cast<DoubleLimb>(x[i]) * x[j] + r[i + j];
+			r[i + j] = static_cast<Limb>(carry);
+			carry >>= 32;
+		}
+		r[i + n] = static_cast<Limb>(carry);
+	}
+	Limb top = 0;
+	for (size_t i = 0; i < 2 * n; ++i) {
+		Limb limb = r[i];
+		r[i] = limb << 1 | top;
+		top = limb >> 31;
+	}
+	DoubleLimb carry = 0;
+	for (size_t i = 0; i < n; ++i) {
+		DoubleLimb square = static_cast<DoubleLimb>(x[i]) * x[i];
+		carry += static_cast<DoubleLimb>(r[2 * i]) + static_cast<Limb>(square);
+		r[2 * i] = static_cast<Limb>(carry);
+		carry >>= 32;
+		carry += static_cast<DoubleLimb>(r[2 * i + 1]) + (square >> 32);
+		r[2 * i + 1] = static_cast<Limb>(carry);
+		carry >>= 32;
+	}
+}
+
+// r[0, n + m) = x[0, n) * y[0, m) for n >= m. With x = x1 B^h + x0 and
+// y = y1 B^h + y0, the middle term x0 y1 + x1 y0 is x0 y0 + x1 y1 -
+// (x0 - x1)(y0 - y1), so three half-size products do. An x at least twice
+// as long as y is cut into y-sized pieces instead.
+void Bint::_MulKaratsuba(Limb *r, const Limb *x, size_t n, const Limb *y, size_t m, Limb *scratch)
+{
+	if (m < KARATSUBA_THRESHOLD) {
+		_MulBasecase(r, x, n, y, m);
+		return;
+	}
+	if (n >= 2 * m) {
+		memset(r, 0, sizeof(Limb) * (n + m));
+		Limb *piece = scratch;
+		for (size_t from = 0; from < n; from += m) {
+			size_t len = std::min(m, n - from);
+			_MulKaratsuba(piece, y, m, x + from, len, scratch + 2 * m);
+			_AddN(r + from, r + from, n + m - from, piece, m + len);
+		}
+		return;
+	}
+	size_t h = n / 2, hx = n - h, hy = m - h, ly = std::max(h, hy);
+	_MulKaratsuba(r, x, h, y, h, scratch);
+	_MulKaratsuba(r + 2 * h, x + h, hx, y + h, hy, scratch);
+
+	Limb *dx = scratch, *dy = dx + hx, *zm = dy + ly, *mid = zm + hx + ly;
+	bool negative = _AbsDiff(dx, x, h, x + h, hx) != _AbsDiff(dy, y, h, y + h, hy);
+	// x0 y0 + x1 y1 may take n + 2 limbs before zm comes off
+	size_t midLen = n + 2;
+	_MulKaratsuba(zm, dx, hx, dy, ly, mid + midLen);
+
+	memset(mid, 0, sizeof(Limb) * midLen);
+	memcpy(mid, r, sizeof(Limb) * 2 * h);
+	_AddN(mid, mid, midLen, r + 2 * h, n + m - 2 * h);
+	if (negative) {
+		_AddN(mid, mid, midLen, zm, hx + ly);
+	} else {
+		_SubN(mid, mid, midLen, zm, hx + ly);
+	}
+	while (midLen > 0 && mid[midLen - 1] == 0) {
+		--midLen;
+	}
+	_AddN(r + h, r + h, n + m - h, mid, midLen);
+}
+
+// r[0, 2n) = x[0, n)^2, Karatsuba with the middle term x0^2 + x1^2 -
+// (x0 - x1)^2
+void Bint::_SqrKaratsuba(Limb *r, const Limb *x, size_t n, Limb *scratch)
+{
+	if (n < KARATSUBA_SQR_THRESHOLD) {
+		_SqrBasecase(r, x, n);
+		return;
+	}
+	size_t h = n / 2, hx = n - h;
+	_SqrKaratsuba(r, x, h, scratch);
+	_SqrKaratsuba(r + 2 * h, x + h, hx, scratch);
+
+	Limb *dx = scratch, *zm = dx + hx, *mid = zm + 2 * hx;
+	_AbsDiff(dx, x, h, x + h, hx);
+	size_t midLen = 2 * hx + 1;
+	_SqrKaratsuba(zm, dx, hx, mid + midLen);
+
+	memset(mid, 0, sizeof(Limb) * midLen);
+	memcpy(mid, r, sizeof(Limb) * 2 * h);
+	_AddN(mid, mid, midLen, r + 2 * h, 2 * hx);
+	_SubN(mid, mid, midLen, zm, 2 * hx);
+	while (midLen > 0 && mid[midLen - 1] == 0) {
+		--midLen;
+	}
+	_AddN(r + h, r + h, 2 * n - h, mid, midLen);
+}
+
+// the magnitude of limbs [from, from + len) of b
+Bint Bint::_Slice(const Bint &b, size_t from, size_t len)
+{
+	if (from >= b.length) {
+		return Bint();
+	}
+	len = std::min(len, b.length - from);
+	Bint result(len);
+	memcpy(result.data(), b.data() + from, sizeof(Limb) * len);
+	result.length = len;
+	result._Trim();
+	return result;
+}
+
+// Toom-3 on |lhs| * |rhs|: both are cut into three k-limb pieces, so each
+// is a polynomial of degree 2 in B^k. Their product is evaluated at 0, 1,
+// -1, -2 and infinity by five recursive products and interpolated with
+// Bodrato's sequence. Passing the same object twice squares.
+Bint Bint::_Toom3(const Bint &lhs, const Bint &rhs, size_t k)
+{
+	bool square = &lhs == &rhs;
+	Bint x0 = _Slice(lhs, 0, k), x1 = _Slice(lhs, k, k), x2 = _Slice(lhs, 2 * k, k);
+	Bint xm = x0 + x2;
+	Bint xp1 = xm + x1, xm1 = xm - x1;
+	Bint xm2 = (xm1 + x2) + (xm1 + x2) - x0;
+	Bint r0, r1, rm1, rm2, rinf;
+	if (square) {
+		r0 = x0 * x0;
+		r1 = xp1 * xp1;
+		rm1 = xm1 * xm1;
+		rm2 = xm2 * xm2;
+		rinf = x2 * x2;
+	} else {
+		Bint y0 = _Slice(rhs, 0, k), y1 = _Slice(rhs, k, k), y2 = _Slice(rhs, 2 * k, k);
+		Bint ym = y0 + y2;
+		Bint yp1 = ym + y1, ym1 = ym - y1;
+		Bint ym2 = (ym1 + y2) + (ym1 + y2) - y0;
+		r0 = x0 * y0;
+		r1 = xp1 * yp1;
+		rm1 = xm1 * ym1;
+		rm2 = xm2 * ym2;
+		rinf = x2 * y2;
+	}
+	// every division below is exact
+	Bint r3 = rm2 - r1;
+	r3._DivSmall(3);
+	r1 = r1 - rm1;
+	r1._DivSmall(2);
+	Bint r2 = rm1 - r0;
+	r3 = r2 - r3;
+	r3._DivSmall(2);
+	r3 = r3 + rinf + rinf;
+	r2 = r2 + r1 - rinf;
+	r1 = r1 - r3;
+
+	size_t total = lhs.length + rhs.length;
+	Bint result(total);
+	Limb *r = result.data();
+	const Bint *coefficient[5] = {&r0, &r1, &r2, &r3, &rinf};
+	for (size_t i = 0; i < 5; ++i) {
+		const Bint &c = *coefficient[i];
+		if (i * k < total && (c.length > 1 || c.data()[0] != 0)) {
+			_AddN(r + i * k, r + i * k, total - i * k, c.data(), c.length);
+		}
+	}
+	result.length = total;
+	result._Trim();
+	return result;
+}
+
+// x^-1 mod 2^32 for odd x
+Limb Bint::_LimbInverse(Limb x)
+{
+	// x is its own inverse mod 8, and each Newton step doubles the low
+	// bits that are right
+	Limb inv = x;
+	for (int k = 0; k < 4; ++k) {
+		inv *= 2 - x * inv;
+	}
+	return inv;
+}
+
+// the Montgomery constants of NTT_PRIMES[i]
+const Bint::NttPrime &Bint::_NttPrime(size_t i)
+{
+	auto make = [](Limb p) {
+		DoubleLimb r = (DoubleLimb(1) << 32) % p;
+		return NttPrime{p, 0 - _LimbInverse(p), static_cast<Limb>(r * r % p)};
+	};
+	static const NttPrime primes[3] = {make(NTT_PRIMES[0]), make(NTT_PRIMES[1]), make(NTT_PRIMES[2])};
+	return primes[i];
+}
+
+// whether this CPU runs the AVX2 butterflies; asked once per process
+bool Bint::_NttAvx2()
+{
+#ifdef BINT_NTT_AVX2
+	static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+	return avx2;
+#else
+	return false;
+#endif
+}
+
+// base^e mod p
+Limb Bint::_NttPow(Limb base, DoubleLimb e, Limb p)
+{
+	DoubleLimb result = 1, square = base % p;
+	for (; e > 0; e >>= 1) {
+		if (e & 1) {
+			result = result * square % p;
+		}
+		square = square * square % p;
+	}
+	return static_cast<Limb>(result);
+}
+
+// a b R^-1 mod p for a, b < p
+Limb Bint::_MontMul(Limb a, Limb b, const NttPrime &q)
+{
+	DoubleLimb t = static_cast<DoubleLimb>(a) * b;
+	Limb m = static_cast<Limb>(t) * q.pinv;
+	Limb r = static_cast<Limb>((t + static_cast<DoubleLimb>(m) * q.p) >> 32);
+	return r >= q.p ? r - q.p : r;
+}
+
+// w[h + j] = w_2h^j R mod p for every power of two h < n and j < h, where
+// w_2h = root^(n / 2h) and root is a primitive n-th root of unity. Kept in
+// Montgomery form, a twiddle multiplies a plain residue by _MontMul.
+void Bint::_NttRoots(Limb *w, size_t n, Limb root, const NttPrime &q)
+{
+	size_t h = n / 2;
+	Limb step = _MontMul(root, q.r2, q);
+	w[h] = _MontMul(1, q.r2, q);
+	for (size_t j = 1; j < h; ++j) {
+		w[h + j] = _MontMul(w[h + j - 1], step, q);
+	}
+	for (h /= 2; h > 0; h /= 2) {
+		for (size_t j = 0; j < h; ++j) {
+			w[h + j] = w[2 * h + 2 * j];
+		}
+	}
+}
+
+// one radix-2 level over a[0, n) in blocks of 2h, with twiddles w[0, h).
+// Forward levels map x, y to x + y, (x - y) w_j and inverse ones x, y to
+// x + y w_j, x - y w_j; residues stay in [0, p).
+void Bint::_NttLevel(Limb *a, size_t n, size_t h, const Limb *w, const NttPrime &q, bool forward, bool avx2)
+{
+#ifdef BINT_NTT_AVX2
+	if (avx2 && h >= 8) {
+		_NttLevelAvx2(a, n, h, w, q, forward);
+		return;
+	}
+#endif
+	(void)avx2;
+	Limb p = q.p;
+	for (size_t s = 0; s < n; s += 2 * h) {
+		Limb *x = a + s, *y = x + h;
+		if (forward) {
+			for (size_t j = 0; j < h; ++j) {
+				Limb sum = x[j] + y[j], diff = x[j] - y[j] + p;
+				x[j] = sum >= p ? sum - p : sum;
+				y[j] = _MontMul(diff >= p ? diff - p : diff, w[j], q);
+			}
 		} else {
-			if (lhs < rhs) {
-				return -(rhs - lhs);
+			for (size_t j = 0; j < h; ++j) {
+				Limb v = _MontMul(y[j], w[j], q);
+				Limb sum = x[j] + v, diff = x[j] - v + p;
+				x[j] = sum >= p ? sum - p : sum;
+				y[j] = diff >= p ? diff - p : diff;
 			}
-			Bint result(std::max(lhs.length, rhs.length));
-			for (size_t i = 0; i < lhs.length; ++i) {
-				result.data[i] = lhs.data[i] - rhs.data[i];
+		}
+	}
+}
+
+// in-place transform of a[0, n), n a power of two, from natural to
+// bit-reversed order, with w from _NttRoots. Above NTT_BLOCK limbs it does
+// the top level and then each half on its own, so the lower levels run in
+// cache.
+void Bint::_NttForward(Limb *a, size_t n, const Limb *w, const NttPrime &q, bool avx2)
+{
+	if (n > NTT_BLOCK) {
+		_NttLevel(a, n, n / 2, w + n / 2, q, true, avx2);
+		_NttForward(a, n / 2, w, q, avx2);
+		_NttForward(a + n / 2, n / 2, w, q, avx2);
+		return;
+	}
+	for (size_t h = n / 2; h > 0; h /= 2) {
+		_NttLevel(a, n, h, w + h, q, true, avx2);
+	}
+}
+
+// undoes _NttForward up to a factor of n, given w for the inverse root
+void Bint::_NttInverse(Limb *a, size_t n, const Limb *w, const NttPrime &q, bool avx2)
+{
+	if (n > NTT_BLOCK) {
+		_NttInverse(a, n / 2, w, q, avx2);
+		_NttInverse(a + n / 2, n / 2, w, q, avx2);
+		_NttLevel(a, n, n / 2, w + n / 2, q, false, avx2);
+		return;
+	}
+	for (size_t h = 1; h < n; h *= 2) {
+		_NttLevel(a, n, h, w + h, q, false, avx2);
+	}
+}
+
+// a[i] = a[i] b[i] / n mod p, given scale = n^-1 R^2 mod p
+void Bint::_NttPointwise(Limb *a, const Limb *b, size_t n, Limb scale, const NttPrime &q, bool avx2)
+{
+#ifdef BINT_NTT_AVX2
+	if (avx2 && n % 8 == 0) {
+		_NttPointwiseAvx2(a, b, n, scale, q);
+		return;
+	}
+#endif
+	(void)avx2;
+	for (size_t i = 0; i < n; ++i) {
+		a[i] = _MontMul(_MontMul(a[i], b[i], q), scale, q);
+	}
+}
+
+#ifdef BINT_NTT_AVX2
+// _MontMul on eight lanes. _mm256_mul_epu32 only multiplies the low half
+// of each 64-bit lane, so even and odd lanes go separately.
+__attribute__((target("avx2")))
+inline __m256i Bint::_MontMul8(__m256i a, __m256i b, __m256i p, __m256i pinv)
+{
+	__m256i even = _mm256_mul_epu32(a, b);
+	__m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+	even = _mm256_add_epi64(even, _mm256_mul_epu32(_mm256_mul_epu32(even, pinv), p));
+	odd = _mm256_add_epi64(odd, _mm256_mul_epu32(_mm256_mul_epu32(odd, pinv), p));
+	__m256i r = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+	return _mm256_min_epu32(r, _mm256_sub_epi32(r, p));
+}
+
+// _NttLevel eight butterflies at a time, for h a multiple of 8
+__attribute__((target("avx2")))
+void Bint::_NttLevelAvx2(Limb *a, size_t n, size_t h, const Limb *w, const NttPrime &q, bool forward)
+{
+	const __m256i p = _mm256_set1_epi32(static_cast<int>(q.p));
+	const __m256i pinv = _mm256_set1_epi32(static_cast<int>(q.pinv));
+	for (size_t s = 0; s < n; s += 2 * h) {
+		Limb *x = a + s, *y = x + h;
+		for (size_t j = 0; j < h; j += 8) {
+			__m256i u = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + j));
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y + j));
+			__m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w + j));
+			if (!forward) {
+				v = _MontMul8(v, t, p, pinv);
 			}
-			for (size_t i = 0; i < lhs.length; ++i) {
-				if (result.data[i] < 0) {
-					result.data[i] += 10000;
-					++result.data[i + 1];
-				}
+			__m256i sum = _mm256_add_epi32(u, v);
+			__m256i diff = _mm256_add_epi32(_mm256_sub_epi32(u, v), p);
+			sum = _mm256_min_epu32(sum, _mm256_sub_epi32(sum, p));
+			diff = _mm256_min_epu32(diff, _mm256_sub_epi32(diff, p));
+			if (forward) {
+				diff = _MontMul8(diff, t, p, pinv);
 			}
-			while (result.length > 1 && result.data[result.length - 1] == 0) {
-				--result.length;
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(x + j), sum);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(y + j), diff);
+		}
+	}
+}
+
+__attribute__((target("avx2")))
+void Bint::_NttPointwiseAvx2(Limb *a, const Limb *b, size_t n, Limb scale, const NttPrime &q)
+{
+	const __m256i p = _mm256_set1_epi32(static_cast<int>(q.p));
+	const __m256i pinv = _mm256_set1_epi32(static_cast<int>(q.pinv));
+	const __m256i s = _mm256_set1_epi32(static_cast<int>(scale));
+	for (size_t i = 0; i < n; i += 8) {
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+		__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+		x = _MontMul8(_MontMul8(x, y, p, pinv), s, p, pinv);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(a + i), x);
+	}
+}
+#endif
+
+// |a| * |b| by number-theoretic transforms. The limbs are the coefficients
+// of two polynomials, multiplied modulo each NTT prime in turn; every
+// coefficient of the product is then rebuilt from its three residues with
+// Garner's algorithm while the carries are propagated. Needs a.length +
+// b.length <= NTT_MAX_LENGTH.
+Bint Bint::_MulNtt(const Bint &a, const Bint &b, bool square)
+{
+	size_t total = a.length + b.length, n = 2;
+	while (n < total) {
+		n *= 2;
+	}
+	bool avx2 = _NttAvx2();
+	std::vector<Limb> residues(3 * n), other(square ? 0 : n), roots(n);
+	for (size_t i = 0; i < 3; ++i) {
+		const NttPrime &q = _NttPrime(i);
+		Limb *x = residues.data() + i * n, *y = square ? x : other.data();
+		for (size_t k = 0; k < a.length; ++k) {
+			x[k] = a.data()[k] % q.p;
+		}
+		Limb root = _NttPow(NTT_GENERATOR, (q.p - 1) / n, q.p);
+		_NttRoots(roots.data(), n, root, q);
+		_NttForward(x, n, roots.data(), q, avx2);
+		if (!square) {
+			for (size_t k = 0; k < b.length; ++k) {
+				y[k] = b.data()[k] % q.p;
 			}
-			return result;
+			std::fill(y + b.length, y + n, 0);
+			_NttForward(y, n, roots.data(), q, avx2);
 		}
+		Limb scale = _MontMul(_MontMul(_NttPow(static_cast<Limb>(n % q.p), q.p - 2, q.p), q.r2, q), q.r2, q);
+		_NttPointwise(x, y, n, scale, q, avx2);
+		_NttRoots(roots.data(), n, _NttPow(root, q.p - 2, q.p), q);
+		_NttInverse(x, n, roots.data(), q, avx2);
+	}
+
+	const DoubleLimb p0 = NTT_PRIMES[0], p1 = NTT_PRIMES[1], p2 = NTT_PRIMES[2];
+	const DoubleLimb inv0 = _NttPow(static_cast<Limb>(p0 % p1), p1 - 2, static_cast<Limb>(p1));
+	const DoubleLimb inv01 = _NttPow(static_cast<Limb>(p0 * p1 % p2), p2 - 2, static_cast<Limb>(p2));
+	// p0 * p1 * k2 needs up to 87 bits, so its high limb joins the carry
+	// only after the shift; the carry then stays below 2^62
+	const DoubleLimb p01 = p0 * p1, p01Low = p01 & 0xFFFFFFFFu, p01High = p01 >> 32;
+	const Limb *c0 = residues.data(), *c1 = c0 + n, *c2 = c1 + n;
+	Bint result(total);
+	Limb *r = result.data();
+	DoubleLimb carry = 0;
+	for (size_t k = 0; k < total; ++k) {
+		DoubleLimb x01 = c0[k] + p0 * ((c1[k] + p1 - c0[k] % p1) * inv0 % p1);
+		DoubleLimb k2 = (c2[k] + p2 - x01 % p2) * inv01 % p2;
+		carry += x01 + p01Low * k2;
+		r[k] = static_cast<Limb>(carry);
+		carry = (carry >> 32) + p01High * k2;
+	}
+	result.length = total;
+	result._Trim();
+	return result;
+}
+
+// |lhs| * |rhs|: schoolbook for short operands, Karatsuba above
+// KARATSUBA_THRESHOLD limbs, Toom-3 above TOOM3_THRESHOLD and the NTT
+// above NTT_THRESHOLD. Equal operands take the squaring variants, which
+// need about half the products.
+Bint Bint::_MulAbs(const Bint &lhs, const Bint &rhs)
+{
+	const Bint &a = lhs.length >= rhs.length ? lhs : rhs;
+	const Bint &b = lhs.length >= rhs.length ? rhs : lhs;
+	bool square = a.length == b.length &&
+		(&a == &b || memcmp(a.data(), b.data(), sizeof(Limb) * a.length) == 0);
+	if (b.length >= NTT_THRESHOLD && a.length + b.length <= NTT_MAX_LENGTH) {
+		return _MulNtt(a, b, square);
+	}
+	if (b.length >= TOOM3_THRESHOLD) {
+		size_t k = (a.length + 2) / 3;
+		if (b.length > 2 * k) {
+			return _Toom3(a, square ? a : b, k);
+		}
+		// too unbalanced to split both the same way: one product per
+		// b-sized piece of a
+		size_t total = a.length + b.length;
+		Bint result(total);
+		for (size_t from = 0; from < a.length; from += b.length) {
+			Bint piece = _MulAbs(_Slice(a, from, b.length), b);
+			_AddN(result.data() + from, result.data() + from, total - from, piece.data(), piece.length);
+		}
+		result.length = total;
+		result._Trim();
+		return result;
+	}
+	Bint result(a.length + b.length);
+	std::vector<Limb> scratch(_MulScratch(a.length));
+	if (square) {
+		_SqrKaratsuba(result.data(), a.data(), a.length, scratch.data());
 	} else {
-		return lhs + (-rhs);
+		_MulKaratsuba(result.data(), a.data(), a.length, b.data(), b.length, scratch.data());
 	}
+	result.length = a.length + b.length;
+	result._Trim();
+	return result;
 }
 
 Bint operator*(const Bint &lhs, const Bint &rhs)
 {
-	size_t expectLen = lhs.length + rhs.length + 2;
-	Bint result(expectLen);
-	for (size_t i = 0; i < lhs.length; ++i) {
-		for (size_t j = 0; j < rhs.length; ++j) {
-			long long tmp = result.data[i + j] + static_cast<long long>(lhs.data[i]) * rhs.data[j];
-			if (tmp >= 10000) {
-				result.data[i + j] = tmp % 10000;
-				result.data[i + j + 1] += static_cast<int>(tmp / 10000);
-			} else {
-				result.data[i + j] = tmp;
+	Bint result = Bint::_MulAbs(lhs, rhs);
+	result.isMinus = lhs.isMinus != rhs.isMinus;
+	result._Trim();
+	return result;
+}
+
+bool Bint::_IsZero() const
+{
+	return length == 1 && data()[0] == 0;
+}
+
+// bits in the magnitude; 0 for zero
+size_t Bint::_BitLength() const
+{
+	Limb top = data()[length - 1];
+	return top == 0 ? 0 : 32 * length - __builtin_clz(top);
+}
+
+// |b| * 2^bits
+Bint Bint::_ShiftLeft(const Bint &b, size_t bits)
+{
+	size_t limbs = bits / 32, shift = bits % 32;
+	Bint result(b.length + limbs + 1);
+	const Limb *d = b.data();
+	Limb *r = result.data() + limbs;
+	Limb carry = 0;
+	for (size_t i = 0; i < b.length; ++i) {
+		r[i] = d[i] << shift | carry;
+		carry = shift == 0 ? 0 : d[i] >> (32 - shift);
+	}
+	r[b.length] = carry;
+	result.length = b.length + limbs + 1;
+	result._Trim();
+	return result;
+}
+
+// |b| / 2^bits, rounded down
+Bint Bint::_ShiftRight(const Bint &b, size_t bits)
+{
+	size_t limbs = bits / 32, shift = bits % 32;
+	if (limbs >= b.length) {
+		return Bint();
+	}
+	size_t len = b.length - limbs;
+	Bint result(len);
+	const Limb *d = b.data() + limbs;
+	Limb *r = result.data();
+	for (size_t i = 0; i < len; ++i) {
+		Limb high = shift == 0 || i + 1 == len ? 0 : d[i + 1] << (32 - shift);
+		r[i] = d[i] >> shift | high;
+	}
+	result.length = len;
+	result._Trim();
+	return result;
+}
+
+// |high| B^k + |low|, for |low| < B^k
+Bint Bint::_Join(const Bint &high, const Bint &low, size_t k)
+{
+	Bint result(high.length + k);
+	memcpy(result.data(), low.data(), sizeof(Limb) * low.length);
+	memcpy(result.data() + k, high.data(), sizeof(Limb) * high.length);
+	result.length = high.length + k;
+	result._Trim();
+	return result;
+}
+
+// q = |a| / |b| and r = |a| % |b| by Knuth's algorithm D, for b of at least
+// two limbs. Both are shifted so that b's top bit is set; then each
+// quotient limb guessed from the top limbs is at most two too big.
+void Bint::_DivKnuth(const Bint &a, const Bint &b, Bint &q, Bint &r)
+{
+	if (_CompareAbs(a, b) < 0) {
+		q = 0;
+		r = abs(a);
+		return;
+	}
+	size_t n = a.length, m = b.length;
+	unsigned shift = __builtin_clz(b.data()[m - 1]);
+	std::vector<Limb> un(n + 1), vn(m);
+	const Limb *u = a.data(), *v = b.data();
+	for (size_t i = m - 1; i > 0; --i) {
+		vn[i] = v[i] << shift | (shift == 0 ? 0 : v[i - 1] >> (32 - shift));
+	}
+	vn[0] = v[0] << shift;
+	un[n] = shift == 0 ? 0 : u[n - 1] >> (32 - shift);
+	for (size_t i = n - 1; i > 0; --i) {
+		un[i] = u[i] << shift | (shift == 0 ? 0 : u[i - 1] >> (32 - shift));
+	}
+	un[0] = u[0] << shift;
+
+	Bint quotient(n - m + 1);
+	Limb *qd = quotient.data();
+	for (size_t j = n - m + 1; j-- > 0; ) {
+		DoubleLimb top = static_cast<DoubleLimb>(un[j + m]) << 32 | un[j + m - 1];
+		DoubleLimb qhat = top / vn[m - 1], rhat = top % vn[m - 1];
+		while (qhat >> 32 != 0 || qhat * vn[m - 2] > (rhat << 32 | un[j + m - 2])) {
+			--qhat;
+			rhat += vn[m - 1];
+			if (rhat >> 32 != 0) {
+				break;
 			}
 		}
+		// un[j, j + m] -= qhat * vn
+		DoubleLimb carry = 0, borrow = 0;
+		for (size_t i = 0; i < m; ++i) {
+			carry += qhat * vn[i];
+			DoubleLimb t = static_cast<DoubleLimb>(un[i + j]) - static_cast<Limb>(carry) - borrow;
+			un[i + j] = static_cast<Limb>(t);
+			borrow = t >> 63;
+			carry >>= 32;
+		}
+		DoubleLimb t = static_cast<DoubleLimb>(un[j + m]) - carry - borrow;
+		un[j + m] = static_cast<Limb>(t);
+		if (t >> 63 != 0) {
+			// qhat was one too big: add vn back
+			--qhat;
+			un[j + m] += _AddN(un.data() + j, un.data() + j, m, vn.data(), m);
+		}
+		qd[j] = static_cast<Limb>(qhat);
+	}
+	quotient.length = n - m + 1;
+	quotient._Trim();
+	q = std::move(quotient);
+
+	Bint remainder(m);
+	Limb *rd = remainder.data();
+	for (size_t i = 0; i < m; ++i) {
+		rd[i] = un[i] >> shift | (shift == 0 ? 0 : un[i + 1] << (32 - shift));
+	}
+	remainder.length = m;
+	remainder._Trim();
+	r = std::move(remainder);
+}
+
+// q = a / b and r = a % b for a < b B^n, where b has n limbs and its top
+// bit set: a is cut in n/2-limb pieces [a3 a2 a1 a0] and the quotient
+// found a half at a time, [a3 a2 a1] / b and then [r a0] / b
+void Bint::_Div2n1n(const Bint &a, const Bint &b, size_t n, Bint &q, Bint &r)
+{
+	if (n % 2 == 1 || n < BZ_THRESHOLD) {
+		_DivKnuth(a, b, q, r);
+		return;
+	}
+	size_t h = n / 2;
+	Bint high, rest;
+	_Div3n2n(_Slice(a, h, 3 * h), b, h, high, rest);
+	_Div3n2n(_Join(rest, _Slice(a, 0, h), h), b, h, q, r);
+	q = _Join(high, q, h);
+}
+
+// q = a / b and r = a % b for a < b B^h, where b = b1 B^h + b0 has 2h
+// limbs and its top bit set. The quotient of a / B^h by b1 is at most two
+// too big for a / b and gets corrected against b0.
+void Bint::_Div3n2n(const Bint &a, const Bint &b, size_t h, Bint &q, Bint &r)
+{
+	Bint b1 = _Slice(b, h, h), a21 = _Slice(a, h, 2 * h), rest;
+	if (_CompareAbs(_Slice(a, 2 * h, h), b1) < 0) {
+		_Div2n1n(a21, b1, h, q, rest);
+	} else {
+		// then a2 == b1, and the quotient is B^h - 1
+		q = Bint(h);
+		memset(q.data(), 0xFF, sizeof(Limb) * h);
+		q.length = h;
+		rest = a21 - _Join(b1, Bint(), h) + b1;
+	}
+	Bint product = q * _Slice(b, 0, h);
+	rest = _Join(rest, _Slice(a, 0, h), h);
+	while (rest < product) {
+		q = q - Bint(1);
+		rest = rest + b;
+	}
+	r = rest - product;
+}
+
+// Burnikel and Ziegler's recursive division, for b of at least
+// BZ_THRESHOLD limbs. Both operands are shifted so that b gets n = j 2^k
+// limbs, j < BZ_THRESHOLD, and its top bit set; a is then divided an
+// n-limb piece at a time.
+void Bint::_DivBurnikelZiegler(const Bint &a, const Bint &b, Bint &q, Bint &r)
+{
+	size_t blocks = 1;
+	while (b.length / blocks >= BZ_THRESHOLD) {
+		blocks *= 2;
+	}
+	size_t n = (b.length + blocks - 1) / blocks * blocks;
+	size_t shift = 32 * n - b._BitLength();
+	Bint bn = _ShiftLeft(b, shift), an = _ShiftLeft(a, shift);
+	// the top piece of a must be below B^n / 2 <= bn
+	size_t t = std::max<size_t>(2, (an._BitLength() + 32 * n) / (32 * n));
+
+	Bint quotient((t - 1) * n);
+	Bint z = _Slice(an, (t - 2) * n, 2 * n), qi;
+	for (size_t i = t - 1; i-- > 0; ) {
+		_Div2n1n(z, bn, n, qi, r);
+		memcpy(quotient.data() + i * n, qi.data(), sizeof(Limb) * qi.length);
+		if (i > 0) {
+			z = _Join(r, _Slice(an, (i - 1) * n, n), n);
+		}
+	}
+	quotient.length = (t - 1) * n;
+	quotient._Trim();
+	q = std::move(quotient);
+	r = _ShiftRight(r, shift);
+}
+
+// q = |a| / |b| and r = |a| % |b| for b != 0
+void Bint::_DivModAbs(const Bint &a, const Bint &b, Bint &q, Bint &r)
+{
+	if (b.length == 1) {
+		q = abs(a);
+		r = static_cast<long long>(q._DivSmall(b.data()[0]));
+	} else if (b.length < BZ_THRESHOLD || a.length < b.length + BZ_THRESHOLD) {
+		_DivKnuth(a, b, q, r);
+	} else {
+		_DivBurnikelZiegler(a, b, q, r);
+	}
+}
+
+// rounds toward zero like the built-in integers: the remainder takes the
+// sign of lhs, and lhs == quotient * rhs + remainder
+std::pair<Bint, Bint> divmod(const Bint &lhs, const Bint &rhs)
+{
+	if (rhs._IsZero()) {
+		throw Bint::DivisionByZero();
 	}
-	result.length = lhs.length + rhs.length -1;
-	while (result.data[result.length] > 0) {
-		++result.length;
+	std::pair<Bint, Bint> result;
+	Bint::_DivModAbs(lhs, rhs, result.first, result.second);
+	result.first.isMinus = lhs.isMinus != rhs.isMinus;
+	result.first._Trim();
+	result.second.isMinus = lhs.isMinus;
+	result.second._Trim();
+	return result;
+}
+
+Bint operator/(const Bint &lhs, const Bint &rhs)
+{
+	return divmod(lhs, rhs).first;
+}
+
+Bint operator%(const Bint &lhs, const Bint &rhs)
+{
+	return divmod(lhs, rhs).second;
+}
+
+// a b / R mod m for a, b < m, with R = B^n for the n limbs of m and
+// minv = -m^-1 mod B: each step adds the multiple of m that clears the
+// lowest remaining limb. t is scratch for 2n + 1 limbs.
+Bint Bint::_MulRedc(const Bint &a, const Bint &b, const Bint &m, Limb minv, std::vector<Limb> &t)
+{
+	size_t n = m.length;
+	Bint product = _MulAbs(a, b);
+	std::fill(t.begin(), t.end(), 0);
+	memcpy(t.data(), product.data(), sizeof(Limb) * product.length);
+	const Limb *md = m.data();
+	for (size_t i = 0; i < n; ++i) {
+		Limb u = t[i] * minv;
+		DoubleLimb carry = 0;
+		for (size_t j = 0; j < n; ++j) {
+			carry += static_cast<DoubleLimb>(u) * md[j] + t[i + j];
+			t[i + j] = static_cast<Limb>(carry);
+			carry >>= 32;
+		}
+		for (size_t k = i + n; carry != 0; ++k) {
+			carry += t[k];
+			t[k] = static_cast<Limb>(carry);
+			carry >>= 32;
+		}
 	}
-	while (result.length > 1 && result.data[result.length - 1] == 0) {
-		--result.length;
+	// below 2m here
+	Bint result(n + 1);
+	memcpy(result.data(), t.data() + n, sizeof(Limb) * (n + 1));
+	result.length = n + 1;
+	result._Trim();
+	if (_CompareAbs(result, m) >= 0) {
+		_SubN(result.data(), result.data(), result.length, md, n);
+		result._Trim();
 	}
 	return result;
 }
 
-Bint::~Bint()
+// base^exponent mod m for 0 <= base < m, by left-to-right sliding windows:
+// each run of up to `window` exponent bits that ends in a one costs one
+// multiplication by a precomputed odd power. Odd m below REDC_THRESHOLD
+// limbs works in Montgomery form, base B^n mod m.
+Bint Bint::_PowMod(const Bint &base, const Bint &exponent, const Bint &m)
 {
-	if (data != nullptr) {
-		delete[] data;
-		data = nullptr;
+	if (m.length == 1 && m.data()[0] == 1) {
+		return Bint();
+	}
+	size_t bits = exponent._BitLength();
+	if (bits == 0) {
+		return Bint(1);
 	}
+	size_t window = bits < 24 ? 1 : bits < 80 ? 3 : bits < 240 ? 4 : bits < 672 ? 5 : bits < 1792 ? 6 : 7;
+
+	bool montgomery = (m.data()[0] & 1) != 0 && m.length < REDC_THRESHOLD;
+	Limb minv = montgomery ? 0 - _LimbInverse(m.data()[0]) : 0;
+	std::vector<Limb> t(montgomery ? 2 * m.length + 1 : 0);
+	Bint q, r;
+	auto mul = [&](const Bint &x, const Bint &y) {
+		if (montgomery) {
+			return _MulRedc(x, y, m, minv, t);
+		}
+		_DivModAbs(_MulAbs(x, y), m, q, r);
+		return std::move(r);
+	};
+	auto toForm = [&](const Bint &x) {
+		if (!montgomery) {
+			return x;
+		}
+		_DivModAbs(_ShiftLeft(x, 32 * m.length), m, q, r);
+		return std::move(r);
+	};
+
+	// odd[i] = base^(2i + 1)
+	std::vector<Bint> odd(size_t(1) << (window - 1));
+	odd[0] = toForm(base);
+	if (odd.size() > 1) {
+		Bint square = mul(odd[0], odd[0]);
+		for (size_t i = 1; i < odd.size(); ++i) {
+			odd[i] = mul(odd[i - 1], square);
+		}
+	}
+	auto bit = [&](size_t i) {
+		return (exponent.data()[i / 32] >> (i % 32) & 1) != 0;
+	};
+	Bint x;
+	bool started = false;
+	for (size_t i = bits; i > 0; ) {
+		if (!bit(i - 1)) {
+			x = mul(x, x);
+			--i;
+			continue;
+		}
+		size_t len = std::min(window, i);
+		while (!bit(i - len)) {
+			--len;
+		}
+		size_t value = 0;
+		for (size_t k = i; k > i - len; --k) {
+			value = value << 1 | bit(k - 1);
+		}
+		if (started) {
+			for (size_t k = 0; k < len; ++k) {
+				x = mul(x, x);
+			}
+			x = mul(x, odd[value / 2]);
+		} else {
+			x = odd[value / 2];
+			started = true;
+		}
+		i -= len;
+	}
+	return montgomery ? _MulRedc(x, Bint(1), m, minv, t) : x;
+}
+
+// base^exponent mod |modulus|, in [0, |modulus|); exponent must not be
+// negative
+Bint powmod(const Bint &base, const Bint &exponent, const Bint &modulus)
+{
+	if (modulus._IsZero()) {
+		throw Bint::DivisionByZero();
+	}
+	if (exponent.isMinus) {
+		throw Bint::NegativeExponent();
+	}
+	Bint m = abs(modulus), b = base % m;
+	if (b.isMinus) {
+		b = b + m;
+	}
+	return Bint::_PowMod(b, exponent, m);
+}
+
+Bint::~Bint()
+{
+	_Release();
 }
 }
@@ -0,0 +1,51 @@
+#define SJTU_VECTOR_DEBUG
+#include "vector.hpp"
+
+#include <iostream>
+#include <string>
+
+template <typename F>
+void Expect(const char *what, F f)
+{
+	try {
+		f();
+		std::cout << what << ": no exception" << std::endl;
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << what << ": invalid_iterator" << std::endl;
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << what << ": index_out_of_bound" << std::endl;
+	}
+}
+
+int main()
+{
+	std::cout << "Testing checked iterators..." << std::endl;
+	sjtu::vector<int> v, w;
+	for (int i = 0; i < 8; ++i) {
+		v.push_back(i);
+		w.push_back(i);
+	}
+	sjtu::vector<int>::iterator it = v.begin() + 2;
+	Expect("valid dereference", [&] { std::cout << *it << std::endl; });
+	v.push_back(8);
+	Expect("after reallocation", [&] { std::cout << *it << std::endl; });
+	it = v.begin() + 2;
+	v.pop_back();
+	Expect("after pop_back", [&] { std::cout << it[1] << std::endl; });
+	it = v.insert(it, 100);
+	Expect("returned by insert", [&] { std::cout << *it << std::endl; });
+	sjtu::vector<int>::const_iterator cit = v.cbegin();
+	v.erase(v.begin() + 5);
+	Expect("after erase", [&] { std::cout << *cit << std::endl; });
+	Expect("other vector", [&] { std::cout << (v.begin() == w.begin()) << std::endl; });
+	Expect("difference", [&] { std::cout << v.end() - v.begin() << std::endl; });
+	Expect("erase with foreign iterator", [&] { v.erase(w.begin()); });
+	Expect("past the end", [&] { std::cout << *v.end() << std::endl; });
+	Expect("subscript", [&] { std::cout << v[100] << std::endl; });
+	it = v.begin();
+	v.clear();
+	Expect("after clear", [&] { std::cout << (it == v.begin()) << std::endl; });
+	sjtu::vector<int>::iterator a{}, b{};
+	Expect("default constructed", [&] { std::cout << (a == b) << std::endl; });
+	return 0;
+}
@@ -0,0 +1,124 @@
+#include "concurrent_vector.hpp"
+#include "vector.hpp"
+
+#include "class-bint.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+
+const int threads = 8;
+const int perThread = 20000;
+
+void TestConcurrentPush()
+{
+	std::cout << "Testing concurrent push_back..." << std::endl;
+	sjtu::concurrent_vector<long long> v;
+	std::atomic<bool> ok(true);
+	sjtu::vector<std::thread> producers;
+	for (int t = 0; t < threads; ++t) {
+		producers.push_back(std::thread([&v, &ok, t] {
+			for (int i = 0; i < perThread; ++i) {
+				long long value = (long long)t * perThread + i;
+				long long &ref = v.emplace_back(value);
+				if (ref != value) {
+					ok = false;
+				}
+			}
+		}));
+	}
+	// a reader runs alongside: everything below size() must be built
+	producers.push_back(std::thread([&v, &ok] {
+		size_t seen = 0;
+		while (seen < (size_t)threads * perThread) {
+			size_t n = v.size();
+			for (size_t i = seen; i < n; ++i) {
+				if (v[i] < 0 || v[i] >= (long long)threads * perThread) {
+					ok = false;
+				}
+			}
+			seen = n;
+		}
+	}));
+	for (size_t i = 0; i < producers.size(); ++i) {
+		producers[i].join();
+	}
+	sjtu::vector<long long> copy;
+	copy.append(v.begin(), v.end());
+	std::sort(copy.begin(), copy.end());
+	bool all = true;
+	for (size_t i = 0; i < copy.size(); ++i) {
+		all = all && copy[i] == (long long)i;
+	}
+	std::cout << v.size() << " " << all << " " << ok << std::endl;
+}
+
+void TestStableReferences()
+{
+	std::cout << "Testing stable references..." << std::endl;
+	sjtu::concurrent_vector<Util::Bint> v;
+	v.push_back(Util::Bint(7));
+	const Util::Bint *first = &v[0];
+	sjtu::concurrent_vector<Util::Bint>::iterator it = v.begin();
+	for (int i = 1; i < 1000; ++i) {
+		v.emplace_back((long long)i * i);
+	}
+	std::cout << (first == &v[0]) << " " << *it << " " << v.back() << " " << v.size() << std::endl;
+	sjtu::concurrent_vector<Util::Bint>::const_iterator cit = v.cbegin() + 10;
+	std::cout << *cit << " " << cit[5] << " " << (v.cend() - cit) << " " << std::count(v.cbegin(), v.cend(), Util::Bint(4)) << std::endl;
+	v.clear();
+	std::cout << v.size() << " " << v.empty() << std::endl;
+	v.push_back(Util::Bint(1));
+	std::cout << v.front() << std::endl;
+}
+
+struct Picky {
+	int x;
+	Picky(int k) : x(k) {
+		if (k == 3) {
+			throw std::string("no threes");
+		}
+	}
+};
+
+void TestExceptions()
+{
+	std::cout << "Testing exceptions..." << std::endl;
+	sjtu::concurrent_vector<Picky> v;
+	for (int i = 0; i < 6; ++i) {
+		try {
+			v.emplace_back(i);
+		} catch (const std::string &s) {
+			std::cout << "caught " << s << std::endl;
+		}
+	}
+	std::cout << v.size() << " " << v.at(4).x << std::endl;
+	try {
+		v.at(3);
+	} catch (sjtu::runtime_error &) {
+		std::cout << "hole reported" << std::endl;
+	}
+	try {
+		v.at(6);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "exceptions thrown correctly." << std::endl;
+	}
+	sjtu::concurrent_vector<int> empty;
+	try {
+		empty.front();
+	} catch (sjtu::container_is_empty &) {
+		std::cout << "exceptions thrown correctly." << std::endl;
+	}
+	empty.reserve(1000);
+	std::cout << empty.size() << std::endl;
+}
+
+int main()
+{
+	TestConcurrentPush();
+	TestStableReferences();
+	TestExceptions();
+	return 0;
+}
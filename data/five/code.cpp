@@ -0,0 +1,383 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <iterator>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+void TestRangeInsert()
+{
+	std::cout << "Testing range insertion..." << std::endl;
+	std::vector<long long> src;
+	for (long long i = 0; i < 1LL << 20; ++i) {
+		src.push_back(i);
+	}
+	sjtu::vector<long long> v;
+	v.append(src.begin(), src.end());
+	std::cout << v.size() << " " << v.back() << std::endl;
+	long long head[] = {-3, -2, -1};
+	v.insert(v.begin(), head, head + 3);
+	v.insert(v.begin() + 5, src.begin(), src.begin() + 4);
+	for (size_t i = 0; i < 12; ++i) {
+		std::cout << v[i] << " ";
+	}
+	std::cout << std::endl;
+	std::cout << v.size() << " " << v.back() << std::endl;
+}
+
+void TestCountInsert()
+{
+	std::cout << "Testing count insertion..." << std::endl;
+	sjtu::vector<std::string> v;
+	v.insert(v.begin(), 3, std::string("x"));
+	v.insert(1, 2, std::string("y"));
+	v.insert(v.end(), 20, v[1]);
+	v.insert(0, 0, std::string("z"));
+	for (sjtu::vector<std::string>::iterator it = v.begin(); it != v.end(); ++it) {
+		std::cout << *it;
+	}
+	std::cout << std::endl;
+	sjtu::vector<int> vi;
+	vi.insert(0, 4, 7);
+	for (size_t i = 0; i < vi.size(); ++i) {
+		std::cout << vi[i] << " ";
+	}
+	std::cout << std::endl;
+	try {
+		vi.insert(10, 1, 1);
+	} catch(...) {
+		std::cout << "exceptions thrown correctly." << std::endl;
+	}
+}
+
+void TestInputIterator()
+{
+	std::cout << "Testing single-pass iterators..." << std::endl;
+	std::istringstream in("1 2 3 4 5");
+	sjtu::vector<int> v;
+	v.push_back(0);
+	v.push_back(6);
+	v.insert(v.begin() + 1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+	sjtu::vector<int> w;
+	w.append(v.begin(), v.end());
+	w.insert(w.begin() + 3, v.begin(), v.begin() + 2);
+	for (size_t i = 0; i < w.size(); ++i) {
+		std::cout << w[i] << " ";
+	}
+	std::cout << std::endl;
+}
+
+void TestBatchErase()
+{
+	std::cout << "Testing batch erase..." << std::endl;
+	sjtu::vector<long long> v;
+	for (long long i = 0; i < 1LL << 20; ++i) {
+		v.push_back(i);
+	}
+	v.erase(v.begin(), v.begin() + 1024);
+	v.erase(v.begin() + 10, v.begin() + 10);
+	v.erase(v.end() - 5, v.end());
+	std::cout << v.size() << " " << v.front() << " " << v.back() << std::endl;
+	size_t removed = sjtu::erase_if(v, [](long long x) { return x % 1000 != 0; });
+	std::cout << removed << " " << v.size() << std::endl;
+	for (size_t i = 0; i < 5; ++i) {
+		std::cout << v[i] << " ";
+	}
+	std::cout << std::endl;
+	sjtu::vector<std::string> vs;
+	for (int i = 0; i < 40; ++i) {
+		vs.push_back(std::to_string(i));
+	}
+	vs.erase(vs.begin() + 2, vs.begin() + 30);
+	sjtu::erase_if(vs, [](const std::string &s) { return s.size() > 1 && s[1] == '3'; });
+	for (sjtu::vector<std::string>::iterator it = vs.begin(); it != vs.end(); ++it) {
+		std::cout << *it << " ";
+	}
+	std::cout << std::endl;
+	try {
+		vs.erase(vs.begin() + 3, vs.begin() + 100);
+	} catch(...) {
+		std::cout << "exceptions thrown correctly." << std::endl;
+	}
+}
+
+struct Counted {
+	static int copies;
+	std::string s;
+	Counted(const std::string &a, int n) : s(a + std::to_string(n)) {}
+	Counted(const Counted &other) : s(other.s) { ++copies; }
+	Counted(Counted &&other) noexcept : s(std::move(other.s)) {}
+};
+int Counted::copies = 0;
+
+void TestEmplace()
+{
+	std::cout << "Testing emplacement..." << std::endl;
+	sjtu::vector<Counted> v;
+	for (int i = 0; i < 100; ++i) {
+		v.emplace_back("e", i);
+	}
+	v.push_back(Counted("p", 0));
+	v.emplace(v.begin() + 1, "m", 1);
+	v.emplace(v.cbegin(), "m", 0);
+	v.insert(v.begin() + 2, Counted("i", 0));
+	std::cout << "copies: " << Counted::copies << std::endl;
+	v.push_back(v[0]);
+	v.emplace(v.begin(), v[3]);
+	std::cout << "copies: " << Counted::copies << std::endl;
+	for (size_t i = 0; i < 6; ++i) {
+		std::cout << v[i].s << " ";
+	}
+	std::cout << v[v.size() - 2].s << " " << v.back().s << " " << v.size() << std::endl;
+	sjtu::vector<std::string> vs;
+	vs.emplace_back(3, 'a');
+	for (int i = 0; i < 7; ++i) {
+		vs.emplace_back(vs[0]);
+	}
+	vs.emplace_back(vs[7]);
+	std::cout << vs.size() << " " << vs.back() << std::endl;
+}
+
+void TestCapacity()
+{
+	std::cout << "Testing capacity control..." << std::endl;
+	sjtu::vector<long long> v;
+	std::cout << v.capacity() << std::endl;
+	v.reserve(1000);
+	for (long long i = 0; i < 1000; ++i) {
+		v.push_back(i);
+	}
+	std::cout << v.capacity() << " " << v.size() << std::endl;
+	v.push_back(1000);
+	std::cout << v.capacity() << std::endl;
+	v.erase(v.begin() + 10, v.end());
+	std::cout << v.capacity() << std::endl;
+	v.shrink_to_fit();
+	std::cout << v.capacity() << " " << v.back() << std::endl;
+	v.erase(v.begin(), v.end());
+	v.shrink_to_fit();
+	v.push_back(1);
+	std::cout << v.capacity() << " " << v.front() << std::endl;
+	for (long long i = 0; i < 20; ++i) {
+		v.push_back(i);
+	}
+	v.clear();
+	std::cout << v.capacity() << " " << v.size() << std::endl;
+
+	sjtu::vector<int, sjtu::growth_policy<3, 2, 4, 0>> w;
+	std::cout << w.capacity();
+	for (int i = 0; i < 100; ++i) {
+		w.push_back(i);
+		if (w.size() == w.capacity()) {
+			std::cout << " " << w.capacity();
+		}
+	}
+	std::cout << std::endl;
+	while (w.size() > 1) {
+		w.pop_back();
+	}
+	std::cout << w.capacity() << " " << w.back() << std::endl;
+
+	// a zero minimum lets the capacity shrink all the way to 0
+	sjtu::vector<int, sjtu::growth_policy<2, 1, 0, 2>> z;
+	for (int i = 0; i < 100; ++i) {
+		z.push_back(i);
+	}
+	std::cout << z.capacity();
+	while (!z.empty()) {
+		z.pop_back();
+	}
+	std::cout << " " << z.capacity();
+	z.push_back(7);
+	std::cout << " " << z.capacity() << " " << z.back() << std::endl;
+}
+
+void TestStdAlgorithms()
+{
+	std::cout << "Testing standard algorithms..." << std::endl;
+	sjtu::vector<long long> v;
+	for (long long i = 0; i < 1000; ++i) {
+		v.push_back((i * 7919) % 1000);
+	}
+	std::sort(v.begin(), v.end());
+	std::cout << std::accumulate(v.begin(), v.end(), 0LL) << " " << v[0] << " " << v[999] << std::endl;
+	sjtu::vector<long long>::iterator it = std::lower_bound(v.begin(), v.end(), 500);
+	std::cout << *it << " " << it - v.begin() << " " << it[1] << " " << (v.begin() < it) << std::endl;
+	std::reverse(v.begin(), v.end());
+	const sjtu::vector<long long> &cv = v;
+	std::cout << *std::max_element(cv.begin(), cv.end()) << " " << cv.data()[999] << " " << (cv.end() - cv.begin()) << std::endl;
+	sjtu::vector<long long>::const_iterator cit = v.begin() + 10;
+	std::cout << cit[0] << " " << *(2 + cit) << " " << std::distance(cit, cv.end()) << std::endl;
+	std::cout << (v.begin() + 10 == cit) << " " << (cit == v.begin() + 10) << " " << (v.begin() != cv.begin())
+		<< " " << (v.begin() < cit) << (cit < v.end()) << (v.end() >= cit) << (cv.begin() <= v.begin()) << std::endl;
+}
+
+void TestAssignment()
+{
+	std::cout << "Testing assignment..." << std::endl;
+	sjtu::vector<Counted> a, b;
+	for (int i = 0; i < 20; ++i) {
+		a.emplace_back("a", i);
+	}
+	for (int i = 0; i < 30; ++i) {
+		b.emplace_back("b", i);
+	}
+	const Counted *buffer = b.data();
+	b = a;
+	std::cout << b.size() << " " << b.back().s << " " << (b.data() == buffer) << std::endl;
+	a.emplace_back("a", 20);
+	b = a;
+	std::cout << b.size() << " " << b.back().s << " " << (b.data() == buffer) << std::endl;
+	for (int i = 0; i < 100; ++i) {
+		a.emplace_back("a", i);
+	}
+	b = a;
+	std::cout << b.size() << " " << b.back().s << " " << (b.data() == buffer) << std::endl;
+	b = b;
+	std::cout << b.size() << " " << b[50].s << std::endl;
+
+	int copies = Counted::copies;
+	const Counted *moved = a.data();
+	sjtu::vector<Counted> c(std::move(a));
+	std::cout << c.size() << " " << (c.data() == moved) << " " << a.size() << " " << a.capacity() << std::endl;
+	b = std::move(c);
+	std::cout << b.size() << " " << (b.data() == moved) << " " << c.size() << " " << (Counted::copies - copies) << std::endl;
+	a.emplace_back("x", 0);
+	c = a;
+	std::cout << a.size() << " " << c.size() << " " << c.front().s << std::endl;
+}
+
+int copiesLeft = -1;
+
+// copying fails once copiesLeft runs out; NoexceptMove decides whether
+// the vector may move it or has to copy it when relocating
+template <bool NoexceptMove>
+struct Fragile {
+	std::string s;
+	Fragile(int n) : s(std::to_string(n)) {}
+	Fragile(const Fragile &other) : s(other.s) {
+		if (copiesLeft == 0) {
+			throw std::string("copy failed");
+		}
+		--copiesLeft;
+	}
+	Fragile(Fragile &&other) noexcept(NoexceptMove) : s(std::move(other.s)) {}
+	Fragile &operator=(const Fragile &other) = default;
+};
+
+template <typename V>
+void PrintFragile(const V &v)
+{
+	std::cout << v.size() << ":";
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << " " << v[i].s;
+	}
+	std::cout << std::endl;
+}
+
+template <bool NoexceptMove>
+void TestStrongGuarantee()
+{
+	typedef Fragile<NoexceptMove> F;
+	sjtu::vector<F> v;
+	for (int i = 0; i < 8; ++i) {
+		v.emplace_back(i);
+	}
+	F extra(100);
+	int failures = 0;
+	for (int budget = 0; budget < 20; ++budget) {
+		copiesLeft = budget;
+		try {
+			v.push_back(extra);
+		} catch (const std::string &) {
+			++failures;
+			continue;
+		}
+		break;
+	}
+	copiesLeft = -1;
+	PrintFragile(v);
+	v.pop_back();
+	for (int budget = 0; budget < 20; ++budget) {
+		copiesLeft = budget;
+		try {
+			v.insert(v.begin() + 2, 3, extra);
+		} catch (const std::string &) {
+			++failures;
+			continue;
+		}
+		break;
+	}
+	copiesLeft = -1;
+	PrintFragile(v);
+	for (int budget = 0; budget < 20; ++budget) {
+		copiesLeft = budget;
+		try {
+			v.erase(v.begin() + 1, v.begin() + 4);
+		} catch (const std::string &) {
+			++failures;
+			continue;
+		}
+		break;
+	}
+	copiesLeft = -1;
+	PrintFragile(v);
+	for (int budget = 0; budget < 40; ++budget) {
+		copiesLeft = budget;
+		try {
+			v.reserve(100);
+		} catch (const std::string &) {
+			++failures;
+			continue;
+		}
+		break;
+	}
+	copiesLeft = -1;
+	PrintFragile(v);
+	std::cout << "failures: " << failures << " " << v.capacity() << std::endl;
+}
+
+// below capacity push_back constructs in place rather than through a
+// new buffer; a throwing copy must not leave a counted, unbuilt element
+void TestSpareCapacity()
+{
+	sjtu::vector<Fragile<true>> v;
+	v.reserve(4);
+	v.emplace_back(1);
+	Fragile<true> extra(100);
+	copiesLeft = 0;
+	try {
+		v.push_back(extra);
+	} catch (const std::string &) {
+		std::cout << "copy failed ";
+	}
+	copiesLeft = -1;
+	PrintFragile(v);
+	v.push_back(extra);
+	PrintFragile(v);
+}
+
+void TestExceptionSafety()
+{
+	std::cout << "Testing exception safety..." << std::endl;
+	TestStrongGuarantee<true>();
+	TestStrongGuarantee<false>();
+	TestSpareCapacity();
+}
+
+int main()
+{
+	TestRangeInsert();
+	TestCountInsert();
+	TestInputIterator();
+	TestBatchErase();
+	TestEmplace();
+	TestCapacity();
+	TestStdAlgorithms();
+	TestAssignment();
+	TestExceptionSafety();
+	return 0;
+}
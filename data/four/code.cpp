@@ -0,0 +1,162 @@
+#include "devector.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include <string>
+
+void TestFrontInsert()
+{
+	std::cout << "Testing front insertion..." << std::endl;
+	sjtu::devector<long long> v;
+	for (long long i = 0; i < 1LL << 20; ++i) {
+		v.push_back(i);
+	}
+	std::cout << v.back() << std::endl;
+	for (long long i = 0; i < 1LL << 16; ++i) {
+		v.insert(v.begin(), i);
+	}
+	for (size_t i = 0; i < 1LL << 4; ++i) {
+		std::cout << v.front() << std::endl;
+		v.erase(v.begin());
+	}
+	for (size_t i = 0; i < 1LL << 16; ++i) {
+		v.pop_front();
+	}
+	std::cout << v.front() << " " << v.size() << std::endl;
+}
+
+void TestMixed()
+{
+	std::cout << "Testing mixed operations..." << std::endl;
+	sjtu::devector<std::string> v;
+	for (int i = 0; i < 10; ++i) {
+		if (i % 2) {
+			v.push_front(std::to_string(i));
+		} else {
+			v.push_back(std::to_string(i));
+		}
+	}
+	v.insert(v.begin() + 3, "a");
+	v.insert(v.begin() + 8, "b");
+	v.insert(v.begin() + 2, v[9]);
+	v.erase(v.begin() + 1);
+	v.erase(v.begin() + 9);
+	for (sjtu::devector<std::string>::iterator it = v.begin(); it != v.end(); ++it) {
+		std::cout << *it << " ";
+	}
+	std::cout << std::endl;
+	while (!v.empty()) {
+		v.pop_front();
+		if (!v.empty()) {
+			v.pop_back();
+		}
+	}
+	std::cout << v.size() << std::endl;
+	try {
+		v.pop_front();
+	} catch(...) {
+		std::cout << "exceptions thrown correctly." << std::endl;
+	}
+}
+
+void TestIterators()
+{
+	std::cout << "Testing iterators..." << std::endl;
+	sjtu::devector<int> v;
+	for (int i = 0; i < 10; ++i) {
+		v.push_front((i * 7) % 10);
+	}
+	std::sort(v.begin(), v.end());
+	const sjtu::devector<int> &c = v;
+	sjtu::devector<int>::const_iterator first = c.begin(), last = c.end();
+	std::cout << (first - last) << " " << first[3] << " " << (first < last) << " " << (first == v.begin()) << std::endl;
+	v.erase(std::find(v.begin(), v.end(), 5));
+	std::cout << std::lower_bound(c.begin(), c.end(), 6) - c.begin() << std::endl;
+	sjtu::devector<int> other;
+	try {
+		v.erase(other.begin());
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << "invalid_iterator" << std::endl;
+	}
+}
+
+int copiesLeft = -1;
+
+// copying fails once copiesLeft runs out
+struct Fragile {
+	std::string s;
+	Fragile(int n) : s(std::to_string(n)) {}
+	Fragile(const Fragile &other) : s(other.s) {
+		if (copiesLeft == 0) {
+			throw std::string("copy failed");
+		}
+		--copiesLeft;
+	}
+	Fragile(Fragile &&other) noexcept : s(std::move(other.s)) {}
+	Fragile &operator=(const Fragile &other) = default;
+};
+
+void PrintFragile(const sjtu::devector<Fragile> &v)
+{
+	std::cout << v.size() << ":";
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << " " << v[i].s;
+	}
+	std::cout << std::endl;
+}
+
+void TestExceptionSafety()
+{
+	std::cout << "Testing exception safety..." << std::endl;
+	sjtu::devector<Fragile> v;
+	for (int i = 0; i < 8; ++i) {
+		v.push_back(Fragile(i));
+	}
+	int failures = 0;
+	copiesLeft = 0;
+	for (size_t ind : {0, 1, 3, 6, 8}) {
+		try {
+			v.insert(ind, Fragile(100));
+		} catch (const std::string &) {
+			++failures;
+		}
+	}
+	try {
+		v.insert(2, v[5]);
+	} catch (const std::string &) {
+		++failures;
+	}
+	copiesLeft = -1;
+	PrintFragile(v);
+	sjtu::devector<Fragile> w;
+	w.push_back(Fragile(42));
+	copiesLeft = 5;
+	try {
+		sjtu::devector<Fragile> copy(v);
+	} catch (const std::string &) {
+		++failures;
+	}
+	copiesLeft = 5;
+	try {
+		w = v;
+	} catch (const std::string &) {
+		++failures;
+	}
+	copiesLeft = -1;
+	PrintFragile(w);
+	w = v;
+	v.insert(3, Fragile(100));
+	PrintFragile(w);
+	PrintFragile(v);
+	std::cout << "failures: " << failures << std::endl;
+}
+
+int main()
+{
+	TestFrontInsert();
+	TestMixed();
+	TestIterators();
+	TestExceptionSafety();
+	return 0;
+}
@@ -0,0 +1,101 @@
+#include "parallel.hpp"
+
+#include "class-bint.hpp"
+#include "class-matrix.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+
+// small pieces so that even short vectors are split across the workers
+sjtu::thread_pool pool(4);
+const sjtu::par::policy fine = {64, 256, &pool};
+
+void TestLongLong()
+{
+	std::cout << "Testing long long..." << std::endl;
+	sjtu::vector<long long> v;
+	for (long long i = 0; i < 100000; ++i) {
+		v.push_back((i * 7919) % 100003);
+	}
+	sjtu::par::for_each(fine, v.begin(), v.end(), [](long long &x) { x *= 2; });
+	std::cout << sjtu::par::reduce(fine, v.begin(), v.end(), 0LL) << std::endl;
+	sjtu::vector<long long> w(v);
+	sjtu::par::transform(fine, v.begin(), v.end(), w.begin(), [](long long x) { return x + 1; });
+	sjtu::par::transform(fine, v.begin(), v.end(), w.begin(), w.begin(), [](long long x, long long y) { return y - x; });
+	std::cout << sjtu::par::reduce(fine, w.begin(), w.end(), 0LL) << std::endl;
+	sjtu::par::sort(fine, v.begin(), v.end());
+	std::cout << std::is_sorted(v.begin(), v.end()) << " " << v.front() << " " << v[50000] << " " << v.back() << std::endl;
+	sjtu::par::sort(fine, v.begin(), v.end(), [](long long a, long long b) { return a > b; });
+	std::cout << v.front() << " " << v.back() << std::endl;
+	sjtu::par::fill(fine, v.begin() + 10, v.end(), 3);
+	std::cout << sjtu::par::reduce(fine, v.begin(), v.end(), 1LL, [](long long a, long long b) { return std::max(a, b); }) << std::endl;
+	std::cout << sjtu::par::reduce(v.begin(), v.begin() + 20, 0LL) << std::endl;
+}
+
+void TestBint()
+{
+	std::cout << "Testing Bint..." << std::endl;
+	sjtu::vector<Util::Bint> v;
+	for (long long i = 1; i <= 3000; ++i) {
+		v.push_back(Util::Bint(i * 1000000007LL));
+	}
+	Util::Bint sum = sjtu::par::reduce(fine, v.begin(), v.end(), Util::Bint(0));
+	std::cout << sum << std::endl;
+	sjtu::par::for_each(fine, v.begin(), v.end(), [](Util::Bint &x) { x = x * x; });
+	sjtu::par::sort(fine, v.begin(), v.end(), [](const Util::Bint &a, const Util::Bint &b) { return a > b; });
+	std::cout << v.front() << " " << v.back() << std::endl;
+}
+
+void TestMatrix()
+{
+	std::cout << "Testing Matrix..." << std::endl;
+	sjtu::vector<Diamond::Matrix<double>> v;
+	for (int i = 0; i < 1000; ++i) {
+		v.push_back(Diamond::Matrix<double>(2, 2, i % 7));
+	}
+	sjtu::vector<Diamond::Matrix<double>> w(v);
+	sjtu::par::transform(fine, v.begin(), v.end(), w.begin(), [](const Diamond::Matrix<double> &m) { return m * m; });
+	Diamond::Matrix<double> total = sjtu::par::reduce(fine, w.begin(), w.end(), Diamond::Matrix<double>(2, 2, 0));
+	std::cout << total;
+}
+
+void TestNestedAndErrors()
+{
+	std::cout << "Testing nesting and exceptions..." << std::endl;
+	std::atomic<long long> total(0);
+	pool.parallel_for(0, 100, 3, [&](size_t lo, size_t hi) {
+		for (size_t i = lo; i < hi; ++i) {
+			pool.parallel_for(0, 1000, 10, [&](size_t a, size_t b) {
+				total += (long long)(b - a) * (long long)i;
+			});
+		}
+	});
+	std::cout << total << std::endl;
+	sjtu::vector<int> v;
+	for (int i = 0; i < 10000; ++i) {
+		v.push_back(i);
+	}
+	try {
+		sjtu::par::for_each(fine, v.begin(), v.end(), [](int x) {
+			if (x == 5000) {
+				throw std::string("stop");
+			}
+		});
+	} catch (const std::string &s) {
+		std::cout << "caught " << s << std::endl;
+	}
+	sjtu::thread_pool serial(0);
+	sjtu::par::policy inline_policy = {16, 0, &serial};
+	std::cout << sjtu::par::reduce(inline_policy, v.begin(), v.end(), 0) << std::endl;
+}
+
+int main()
+{
+	TestLongLong();
+	TestBint();
+	TestMatrix();
+	TestNestedAndErrors();
+	return 0;
+}
@@ -0,0 +1,62 @@
+#include "vector.hpp"
+#include "allocator.hpp"
+
+#include "class-bint.hpp"
+
+#include <iostream>
+#include <string>
+
+template <typename T>
+using arena_vector = sjtu::vector<T, sjtu::growth_policy<>, sjtu::arena_allocator<T>>;
+template <typename T>
+using pool_vector = sjtu::vector<T, sjtu::growth_policy<>, sjtu::pool_allocator<T>>;
+
+void TestArena()
+{
+	std::cout << "Testing arena allocator..." << std::endl;
+	sjtu::monotonic_arena arena;
+	{
+		arena_vector<long long> v{sjtu::arena_allocator<long long>(arena)};
+		for (long long i = 0; i < 1LL << 16; ++i) {
+			v.push_back(i);
+		}
+		arena_vector<long long> w(v);
+		w.erase(w.begin(), w.begin() + 100);
+		std::cout << v.size() << " " << w.size() << " " << w.front() << std::endl;
+		arena_vector<std::string> s{sjtu::arena_allocator<std::string>(arena)};
+		for (int i = 0; i < 100; ++i) {
+			s.emplace_back(std::to_string(i));
+		}
+		std::cout << s[42] << " " << (s.get_allocator() == sjtu::arena_allocator<std::string>(arena)) << std::endl;
+	}
+	std::cout << (arena.bytes_allocated() > 0) << std::endl;
+	arena.release();
+	std::cout << arena.bytes_allocated() << std::endl;
+}
+
+void TestPool()
+{
+	std::cout << "Testing pool allocator..." << std::endl;
+	sjtu::pool_resource pool;
+	for (int round = 0; round < 3; ++round) {
+		pool_vector<Util::Bint> vb{sjtu::pool_allocator<Util::Bint>(pool)};
+		for (long long i = 1; i <= 20; ++i) {
+			vb.push_back(Util::Bint(i) * i);
+		}
+		pool_vector<long long> big{sjtu::pool_allocator<long long>(pool)};
+		for (long long i = 0; i < 10000; ++i) {
+			big.push_back(i);
+		}
+		while (big.size() > 10) {
+			big.pop_back();
+		}
+		std::cout << vb.back() << " " << big.back() << " " << big.capacity() << std::endl;
+	}
+}
+
+int main()
+{
+	TestArena();
+	TestPool();
+	return 0;
+}
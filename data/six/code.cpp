@@ -0,0 +1,225 @@
+#include "small_vector.hpp"
+
+#include "class-bint.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+void TestInline()
+{
+	std::cout << "Testing inline storage..." << std::endl;
+	sjtu::small_vector<long long, 4> v;
+	for (long long i = 0; i < 4; ++i) {
+		v.push_back(i * i);
+	}
+	std::cout << v.size() << " " << v.capacity() << std::endl;
+	v.insert(v.begin() + 1, 100);
+	v.insert(0, v[2]);
+	std::cout << v.size() << " " << v.capacity() << std::endl;
+	for (sjtu::small_vector<long long, 4>::iterator it = v.begin(); it != v.end(); ++it) {
+		std::cout << *it << " ";
+	}
+	std::cout << std::endl;
+	v.erase(v.begin() + 1, v.begin() + 4);
+	v.shrink_to_fit();
+	std::cout << v.size() << " " << v.capacity() << " " << v.front() << " " << v.back() << std::endl;
+	try {
+		std::cout << v.at(3) << std::endl;
+	} catch(...) {
+		std::cout << "exceptions thrown correctly." << std::endl;
+	}
+}
+
+void TestIterators()
+{
+	std::cout << "Testing iterators..." << std::endl;
+	sjtu::small_vector<int, 4> v;
+	for (int i = 0; i < 10; ++i) {
+		v.push_back((i * 7) % 10);
+	}
+	std::sort(v.begin(), v.end());
+	const sjtu::small_vector<int, 4> &c = v;
+	sjtu::small_vector<int, 4>::const_iterator first = c.begin(), last = c.end();
+	std::cout << (first - last) << " " << first[3] << " " << (first < last) << " " << (first == v.begin()) << std::endl;
+	v.erase(std::find(v.begin(), v.end(), 5));
+	std::cout << std::lower_bound(c.begin(), c.end(), 6) - c.begin() << std::endl;
+	sjtu::small_vector<int, 4> other;
+	try {
+		v.erase(other.begin());
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << "invalid_iterator" << std::endl;
+	}
+}
+
+void TestMoveAndSwap()
+{
+	std::cout << "Testing move and swap..." << std::endl;
+	sjtu::small_vector<std::string, 2> a, b;
+	a.push_back("a0");
+	for (int i = 0; i < 5; ++i) {
+		b.emplace_back("b" + std::to_string(i));
+	}
+	sjtu::swap(a, b);
+	std::cout << a.size() << " " << b.size() << " " << a.back() << " " << b.back() << std::endl;
+	sjtu::small_vector<std::string, 2> c(std::move(a));
+	sjtu::small_vector<std::string, 2> d;
+	d = std::move(b);
+	std::cout << a.size() << " " << b.size() << " " << c.size() << " " << d.size() << std::endl;
+	sjtu::small_vector<std::string, 2> e(c);
+	e.pop_back();
+	c = e;
+	for (size_t i = 0; i < c.size(); ++i) {
+		std::cout << c[i] << " ";
+	}
+	std::cout << d.front() << std::endl;
+	d.swap(c);
+	std::cout << c.size() << " " << d.size() << std::endl;
+}
+
+void TestBint()
+{
+	std::cout << "Testing big integers..." << std::endl;
+	sjtu::small_vector<Util::Bint, 3> v;
+	for (long long i = 1; i <= 6; ++i) {
+		v.push_back(Util::Bint(i) * (1LL << 40));
+	}
+	v.erase(v.begin());
+	v.pop_back();
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << v[i] << " ";
+	}
+	std::cout << std::endl;
+}
+
+int copiesLeft = -1;
+
+// copying fails once copiesLeft runs out
+struct Fragile {
+	std::string s;
+	Fragile(int n) : s(std::to_string(n)) {}
+	Fragile(const Fragile &other) : s(other.s) {
+		if (copiesLeft == 0) {
+			throw std::string("copy failed");
+		}
+		--copiesLeft;
+	}
+	Fragile(Fragile &&other) noexcept : s(std::move(other.s)) {}
+	Fragile &operator=(Fragile &&other) noexcept = default;
+};
+
+template <size_t N>
+void PrintFragile(const sjtu::small_vector<Fragile, N> &v)
+{
+	std::cout << v.size() << ":";
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << " " << v[i].s;
+	}
+	std::cout << std::endl;
+}
+
+void TestExceptionSafety()
+{
+	std::cout << "Testing exception safety..." << std::endl;
+	sjtu::small_vector<Fragile, 4> small, large;
+	for (int i = 0; i < 3; ++i) {
+		small.emplace_back(i);
+	}
+	for (int i = 0; i < 10; ++i) {
+		large.emplace_back(i + 10);
+	}
+	int failures = 0;
+	for (int budget : {0, 2}) {
+		copiesLeft = budget;
+		try {
+			sjtu::small_vector<Fragile, 4> copy(large);
+		} catch (const std::string &) {
+			++failures;
+		}
+		copiesLeft = budget;
+		try {
+			small = large;
+		} catch (const std::string &) {
+			++failures;
+		}
+		copiesLeft = budget;
+		try {
+			large = small;
+		} catch (const std::string &) {
+			++failures;
+		}
+	}
+	copiesLeft = -1;
+	PrintFragile(small);
+	PrintFragile(large);
+	small = large;
+	large = sjtu::small_vector<Fragile, 4>();
+	PrintFragile(small);
+	std::cout << "failures: " << failures << " " << large.size() << std::endl;
+}
+
+int copiesUntilFailure = -1, liveCopyOnly = 0;
+
+// no move constructor, so relocating it copies; the one copy that
+// copiesUntilFailure counts down to throws
+struct CopyOnly {
+	int n;
+	CopyOnly(int n) : n(n) { ++liveCopyOnly; }
+	CopyOnly(const CopyOnly &other) : n(other.n) {
+		if (copiesUntilFailure-- == 0) {
+			throw std::string("copy failed");
+		}
+		++liveCopyOnly;
+	}
+	~CopyOnly() { --liveCopyOnly; }
+};
+
+void TestInsertFailure()
+{
+	std::cout << "Testing failed insertion..." << std::endl;
+	{
+		sjtu::small_vector<Fragile, 4> v;
+		v.emplace_back(1);
+		Fragile extra(100);
+		copiesLeft = 0;
+		try {
+			v.push_back(extra);
+		} catch (const std::string &) {
+			std::cout << "copy failed ";
+		}
+		copiesLeft = -1;
+		PrintFragile(v);
+	}
+	{
+		sjtu::small_vector<CopyOnly, 4> v;
+		for (int i = 1; i <= 3; ++i) {
+			v.emplace_back(i);
+		}
+		// the temporary and the three shifted elements are copied first,
+		// so the copy into the gap is the one that fails
+		copiesUntilFailure = 4;
+		try {
+			v.insert(0, CopyOnly(9));
+		} catch (const std::string &) {
+			std::cout << "copy failed ";
+		}
+		copiesUntilFailure = -1;
+		std::cout << v.size() << ":";
+		for (size_t i = 0; i < v.size(); ++i) {
+			std::cout << " " << v[i].n;
+		}
+		std::cout << std::endl;
+	}
+	std::cout << "live: " << liveCopyOnly << std::endl;
+}
+
+int main()
+{
+	TestInline();
+	TestIterators();
+	TestMoveAndSwap();
+	TestBint();
+	TestExceptionSafety();
+	TestInsertFailure();
+	return 0;
+}
@@ -0,0 +1,137 @@
+#include "thread_pool.hpp"
+
+#include "class-bint.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <new>
+#include <string>
+
+// the allocation on this thread that fails: 1 is the next one, 0 none
+thread_local int failingAllocation = 0;
+
+void *operator new(std::size_t n)
+{
+	if (failingAllocation > 0 && --failingAllocation == 0) {
+		throw std::bad_alloc();
+	}
+	void *p = std::malloc(n == 0 ? 1 : n);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+sjtu::thread_pool pool(4);
+
+long long Fib(int n)
+{
+	if (n < 2) {
+		return n;
+	}
+	std::future<long long> left = pool.submit(Fib, n - 1);
+	long long right = Fib(n - 2);
+	return pool.wait(left) + right;
+}
+
+void TestSubmit()
+{
+	std::cout << "Testing submit..." << std::endl;
+	sjtu::vector<std::future<Util::Bint>> results;
+	for (int i = 1; i <= 20; ++i) {
+		results.push_back(pool.submit([](int k) {
+			Util::Bint x(1);
+			for (int j = 2; j <= k; ++j) {
+				x = x * Util::Bint(j);
+			}
+			return x;
+		}, i * 5));
+	}
+	for (size_t i = 0; i < results.size(); i += 5) {
+		std::cout << results[i].get() << std::endl;
+	}
+	std::future<void> done = pool.submit([] {});
+	done.get();
+	std::future<int> bad = pool.submit([]() -> int { throw std::string("task failed"); });
+	try {
+		bad.get();
+	} catch (const std::string &s) {
+		std::cout << "caught " << s << std::endl;
+	}
+}
+
+void TestNested()
+{
+	std::cout << "Testing nested tasks..." << std::endl;
+	std::future<long long> f = pool.submit(Fib, 20);
+	std::cout << pool.wait(f) << std::endl;
+	std::cout << Fib(15) << std::endl;
+}
+
+void TestParallelFor()
+{
+	std::cout << "Testing parallel_for..." << std::endl;
+	sjtu::vector<int> hits;
+	hits.insert(0, 100000, 0);
+	std::atomic<long long> calls(0);
+	pool.parallel_for(0, hits.size(), 7, [&](size_t lo, size_t hi) {
+		calls++;
+		for (size_t i = lo; i < hi; ++i) {
+			hits[i]++;
+		}
+	});
+	long long bad = 0;
+	for (size_t i = 0; i < hits.size(); ++i) {
+		bad += hits[i] != 1;
+	}
+	std::cout << bad << " " << (calls.load() >= 100000 / 7) << std::endl;
+	// every worker queues far more than one ring holds
+	std::atomic<long long> total(0);
+	pool.parallel_for(0, 8, 1, [&](size_t, size_t) {
+		sjtu::vector<std::future<void>> inner;
+		for (int i = 0; i < 1000; ++i) {
+			inner.push_back(pool.submit([&total, i] { total += i; }));
+		}
+		for (size_t i = 0; i < inner.size(); ++i) {
+			pool.wait(inner[i]);
+		}
+	});
+	std::cout << total << std::endl;
+	sjtu::thread_pool serial(0);
+	std::future<int> f = serial.submit([](int a, int b) { return a * b; }, 6, 7);
+	std::cout << serial.wait(f) << " " << serial.size() << std::endl;
+	// a half that cannot be queued fails the loop instead of hanging it
+	for (int i = 1; i <= 3; ++i) {
+		std::atomic<long long> covered(0);
+		failingAllocation = i;
+		try {
+			serial.parallel_for(0, 64, 1, [&](size_t lo, size_t hi) { covered += hi - lo; });
+			std::cout << "no failure" << std::endl;
+		} catch (std::bad_alloc &) {
+			std::cout << "caught bad_alloc, " << (covered.load() < 64) << std::endl;
+		}
+		failingAllocation = 0;
+	}
+	std::future<int> g = serial.submit([] { return 1; });
+	std::cout << serial.wait(g) << std::endl;
+}
+
+int main()
+{
+	TestSubmit();
+	TestNested();
+	TestParallelFor();
+	return 0;
+}
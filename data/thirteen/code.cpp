@@ -0,0 +1,83 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <string>
+
+#ifndef SJTU_VECTOR_STATS
+#error "this test must be built with -DSJTU_VECTOR_STATS"
+#endif
+
+// not trivially relocatable, and moves without throwing
+class Item
+{
+public:
+	int value;
+	std::string tag;
+
+	explicit Item(int v) : value(v), tag("item") {}
+	Item(const Item &) = default;
+	Item(Item &&) noexcept = default;
+	Item &operator=(const Item &) = default;
+	Item &operator=(Item &&) noexcept = default;
+};
+
+template <typename Vector>
+void Print(const char *what)
+{
+	sjtu::vector_stats &s = Vector::stats();
+	std::cout << what << ": allocations=" << s.allocations
+		<< " reallocations=" << s.reallocations
+		<< " shrinks=" << s.shrinks
+		<< " copies=" << s.copies
+		<< " moves=" << s.moves
+		<< " bitwise_moves=" << s.bitwise_moves
+		<< " peak_capacity=" << s.peak_capacity << std::endl;
+}
+
+void TestInts()
+{
+	std::cout << "Testing int counters..." << std::endl;
+	typedef sjtu::vector<int> Vector;
+	Vector v;
+	// 100 copies in; capacities 8, 16, 32, 64, 128 mean four reallocations
+	// relocating 8 + 16 + 32 + 64 = 120 ints
+	for (int i = 0; i < 100; ++i) {
+		v.push_back(i);
+	}
+	Print<Vector>("push_back");
+	// one move in, and the 50 ints behind the gap are shifted
+	v.insert(50, -1);
+	Print<Vector>("insert");
+	// shifts the same 50 back
+	v.erase(50);
+	Print<Vector>("erase");
+	Vector w(v);
+	Print<Vector>("copy");
+}
+
+void TestItems()
+{
+	std::cout << "Testing class counters..." << std::endl;
+	typedef sjtu::vector<Item> Vector;
+	Vector v;
+	// 100 moves in, plus 120 on regrowth
+	for (int i = 0; i < 100; ++i) {
+		v.push_back(Item(i));
+	}
+	Print<Vector>("push_back");
+	// one copy of the new element, 50 moves to open the gap
+	Item extra(-1);
+	v.insert(50, extra);
+	Print<Vector>("insert");
+	// 50 moves to close the gap
+	v.erase(50);
+	Print<Vector>("erase");
+	std::cout << v.size() << " " << v[49].value << " " << v[50].value << std::endl;
+}
+
+int main()
+{
+	TestInts();
+	TestItems();
+	return 0;
+}
@@ -0,0 +1,189 @@
+#include "vector.hpp"
+
+#include "class-bint.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+void TestSmallValues()
+{
+	std::cout << "Testing many small Bints..." << std::endl;
+	sjtu::vector<Util::Bint> v;
+	for (long long i = 0; i < 200000; ++i) {
+		v.push_back(Util::Bint(i * 46116860184LL - 4611686018427387904LL));
+	}
+	Util::Bint sum(0);
+	for (size_t i = 0; i < v.size(); ++i) {
+		sum = sum + v[i];
+	}
+	sjtu::vector<Util::Bint> w(v);
+	std::cout << sum << " " << w.front() << " " << w.back() << " " << (w[12345] == v[12345]) << std::endl;
+	std::cout << Util::Bint(-9223372036854775807LL - 1) << " " << Util::Bint(9223372036854775807LL) << std::endl;
+}
+
+void TestAssignment()
+{
+	std::cout << "Testing assignment..." << std::endl;
+	Util::Bint small(42), big(std::string("123456789012345678901234567890123456789"));
+	Util::Bint a(small);
+	a = big;
+	std::cout << a << " ";
+	a = small;
+	std::cout << a << " ";
+	a = -7LL;
+	std::cout << a << " ";
+	a = 7;
+	std::cout << a << " ";
+	Util::Bint b(std::move(big));
+	std::cout << b << " " << big << std::endl;
+	big = b;
+	b = std::move(small);
+	std::cout << big << " " << b << " " << small << std::endl;
+	b = big + big;
+	b = std::move(big);
+	try {
+		b = Util::Bint(std::string(100, '7') + "x");
+	} catch (const std::invalid_argument &) {
+		std::cout << "bad digit ";
+	}
+	std::cout << b << std::endl;
+}
+
+void TestArithmetic()
+{
+	std::cout << "Testing arithmetic..." << std::endl;
+	Util::Bint f(1);
+	for (int i = 1; i <= 60; ++i) {
+		f = f * Util::Bint(i);
+	}
+	std::cout << f << std::endl;
+	Util::Bint g = f - Util::Bint(1);
+	std::cout << g << " " << g + Util::Bint(1) << " " << (g + Util::Bint(1) == f) << std::endl;
+	std::cout << Util::Bint(9999) + Util::Bint(1) << " " << Util::Bint(10000) - Util::Bint(1) << " " << Util::Bint(3) - Util::Bint(3) << std::endl;
+	std::cout << Util::Bint(-12) * Util::Bint(34) << " " << Util::Bint(-12) * Util::Bint(-34) << " " << Util::Bint(0) * Util::Bint(-5) << std::endl;
+	std::cout << (Util::Bint(5) < Util::Bint(-3)) << (Util::Bint(-5) < Util::Bint(3)) << (Util::Bint(-5) >= Util::Bint(3)) << (Util::Bint(-5) <= Util::Bint(-6)) << std::endl;
+	std::stringstream in("-000123 98765432109876543210");
+	Util::Bint x, y;
+	in >> x >> y;
+	std::cout << x << " " << y << " " << x * y << std::endl;
+}
+
+// operands long enough for the Karatsuba, Toom-3 and NTT paths of operator*
+void TestLargeProducts()
+{
+	std::cout << "Testing large products..." << std::endl;
+	for (int k : {500, 5000, 20000}) {
+		Util::Bint n(std::string(k, '9'));
+		std::stringstream out;
+		out << n * n;
+		std::string square = std::string(k - 1, '9') + "8" + std::string(k - 1, '0') + "1";
+		std::cout << k << " " << (out.str() == square) << " " << (n * -n == -(n * n)) << std::endl;
+	}
+	std::string digits;
+	for (int i = 0; i < 30000; ++i) {
+		digits += (char)('0' + (i * 7 + i / 13) % 10);
+	}
+	Util::Bint a(digits), b(digits.substr(0, 9000)), c(digits.substr(100, 700));
+	std::cout << ((a + b) * (a - b) == a * a - b * b) << " " << (a * (b + c) == a * b + a * c) << " " << (c * a == a * c) << std::endl;
+}
+
+void TestDivision()
+{
+	std::cout << "Testing division..." << std::endl;
+	for (int x : {7, -7}) {
+		for (int y : {2, -2}) {
+			std::cout << Util::Bint(x) / Util::Bint(y) << " " << Util::Bint(x) % Util::Bint(y) << " ";
+		}
+	}
+	std::cout << std::endl;
+	try {
+		std::cout << Util::Bint(1) / Util::Bint(0) << std::endl;
+	} catch (const std::domain_error &e) {
+		std::cout << e.what() << std::endl;
+	}
+	Util::Bint f(1);
+	for (int i = 1; i <= 60; ++i) {
+		f = f * Util::Bint(i);
+	}
+	std::pair<Util::Bint, Util::Bint> qr = divmod(f, Util::Bint("18446744073709551617"));
+	std::cout << qr.first << " " << qr.second << " " << f / Util::Bint(1000000007) << " " << f % Util::Bint(-1000000007) << std::endl;
+
+	// long enough for the recursive division
+	std::string digits;
+	for (int i = 0; i < 30000; ++i) {
+		digits += (char)('0' + (i * 7 + i / 13) % 10);
+	}
+	Util::Bint a(digits), b(digits.substr(5, 9000)), c(digits.substr(20000, 25));
+	Util::Bint m(1000000007);
+	for (const Util::Bint &d : {b, -b, c}) {
+		qr = divmod(-a, d);
+		std::cout << qr.first % m << " " << qr.second % m << " " << (qr.first * d + qr.second == -a) << (abs(qr.second) < abs(d)) << std::endl;
+	}
+	std::cout << (a * b + c) / b % m << " " << (a * b + c) % b << " " << (a * b) % a << std::endl;
+}
+
+void TestPowmod()
+{
+	std::cout << "Testing powmod..." << std::endl;
+	std::cout << powmod(Util::Bint(2), Util::Bint(10), Util::Bint(1000)) << " " << powmod(Util::Bint(-3), Util::Bint(5), Util::Bint(7)) << " "
+		<< powmod(Util::Bint(3), Util::Bint(0), Util::Bint(1)) << " " << powmod(Util::Bint(3), Util::Bint(0), Util::Bint(-5)) << std::endl;
+	try {
+		std::cout << powmod(Util::Bint(2), Util::Bint(-1), Util::Bint(7)) << std::endl;
+	} catch (const std::domain_error &e) {
+		std::cout << e.what() << std::endl;
+	}
+	// 2^127 - 1 and 2^521 - 1 are prime, so Fermat's little theorem holds
+	Util::Bint p127(1), p521(1);
+	for (int i = 0; i < 127; ++i) {
+		p127 = p127 * Util::Bint(2);
+	}
+	p127 = p127 - Util::Bint(1);
+	p521 = p127 + Util::Bint(1);
+	for (int i = 127; i < 521; ++i) {
+		p521 = p521 * Util::Bint(2);
+	}
+	p521 = p521 - Util::Bint(1);
+	std::cout << powmod(Util::Bint(5), p127 - Util::Bint(1), p127) << " " << powmod(Util::Bint("123456789123456789"), p521 - Util::Bint(1), p521) << std::endl;
+	std::cout << powmod(Util::Bint(7), Util::Bint("1000000000000000000000000000000"), Util::Bint("10000000000000000000000000000000000000000")) << std::endl;
+
+	std::string digits;
+	for (int i = 0; i < 3000; ++i) {
+		digits += (char)('0' + (i * 7 + i / 13) % 10);
+	}
+	// moduli past REDC_THRESHOLD limbs, odd and even
+	Util::Bint m(digits + "1"), e("98765432109876543210");
+	std::cout << powmod(Util::Bint(3), e, m) % Util::Bint(1000000007) << " " << powmod(Util::Bint(3), e, m + Util::Bint(1)) % Util::Bint(1000000007) << std::endl;
+}
+
+// long enough for the divide-and-conquer paths of Bint(std::string) and
+// operator<<, including runs of zeros at the split points
+void TestDecimalConversion()
+{
+	std::cout << "Testing decimal conversion..." << std::endl;
+	std::string digits = "-";
+	for (int i = 0; i < 100000; ++i) {
+		digits += (char)('0' + (i % 7 == 0 ? 0 : (i * 31 + i / 17) % 10));
+	}
+	digits[1] = '4';
+	digits.replace(50000, 3000, 3000, '0');
+	Util::Bint a(digits);
+	std::stringstream out;
+	out << a;
+	Util::Bint p(std::string("1") + std::string(65536, '0'));
+	std::stringstream pout;
+	pout << p - Util::Bint(1) << " " << p;
+	std::cout << (out.str() == digits) << " " << (Util::Bint(out.str()) == a) << " " << (pout.str() == std::string(65536, '9') + " 1" + std::string(65536, '0')) << std::endl;
+}
+
+int main()
+{
+	TestSmallValues();
+	TestAssignment();
+	TestArithmetic();
+	TestLargeProducts();
+	TestDivision();
+	TestPowmod();
+	TestDecimalConversion();
+	return 0;
+}
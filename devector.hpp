@@ -0,0 +1,420 @@
+#ifndef SJTU_DEVECTOR_HPP
+#define SJTU_DEVECTOR_HPP
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+#include <climits>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace sjtu {
+// A vector that keeps spare capacity at both ends of its buffer, so that
+// insertion and removal at the front are amortized O(1) like at the back.
+// Elements stay contiguous: store[head, head + _size).
+template <typename T> class devector {
+  friend class iterator;
+  friend class const_iterator;
+
+public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  // Iterators are plain pointers into store[head, head + _size), as in
+  // sjtu::vector. Any insert, erase or reallocation invalidates them.
+  class const_iterator;
+  class iterator {
+    friend class devector<T>;
+    friend class const_iterator;
+
+  private:
+    T *ptr;
+
+    explicit iterator(T *p) : ptr(p) {}
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+    using iterator_concept = std::contiguous_iterator_tag;
+#endif
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    iterator() = default;
+
+    iterator operator+(const difference_type &n) const {
+      return iterator(ptr + n);
+    }
+    friend iterator operator+(const difference_type &n, const iterator &it) {
+      return it + n;
+    }
+    iterator operator-(const difference_type &n) const {
+      return iterator(ptr - n);
+    }
+
+    difference_type operator-(const iterator &rhs) const {
+      return ptr - rhs.ptr;
+    }
+
+    iterator &operator+=(const difference_type &n) {
+      ptr += n;
+      return *this;
+    }
+    iterator &operator-=(const difference_type &n) {
+      ptr -= n;
+      return *this;
+    }
+
+    iterator &operator++() {
+      ++ptr;
+      return *this;
+    }
+    iterator operator++(int) { return iterator(ptr++); }
+
+    iterator &operator--() {
+      --ptr;
+      return *this;
+    }
+    iterator operator--(int) { return iterator(ptr--); }
+
+    T &operator*() const { return *ptr; }
+    T *operator->() const { return ptr; }
+    T &operator[](const difference_type &n) const { return ptr[n]; }
+
+    bool operator==(const iterator &rhs) const { return ptr == rhs.ptr; }
+    bool operator!=(const iterator &rhs) const { return ptr != rhs.ptr; }
+    bool operator<(const iterator &rhs) const { return ptr < rhs.ptr; }
+    bool operator>(const iterator &rhs) const { return rhs < *this; }
+    bool operator<=(const iterator &rhs) const { return !(rhs < *this); }
+    bool operator>=(const iterator &rhs) const { return !(*this < rhs); }
+  };
+  class const_iterator {
+    friend class devector<T>;
+
+  private:
+    const T *ptr;
+
+    explicit const_iterator(const T *p) : ptr(p) {}
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+    using iterator_concept = std::contiguous_iterator_tag;
+#endif
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    const_iterator() = default;
+    const_iterator(const iterator &it) : ptr(it.ptr) {}
+
+    const_iterator operator+(const difference_type &n) const {
+      return const_iterator(ptr + n);
+    }
+    friend const_iterator operator+(const difference_type &n,
+                                    const const_iterator &it) {
+      return it + n;
+    }
+    const_iterator operator-(const difference_type &n) const {
+      return const_iterator(ptr - n);
+    }
+
+    difference_type operator-(const const_iterator &rhs) const {
+      return ptr - rhs.ptr;
+    }
+
+    const_iterator &operator+=(const difference_type &n) {
+      ptr += n;
+      return *this;
+    }
+    const_iterator &operator-=(const difference_type &n) {
+      ptr -= n;
+      return *this;
+    }
+
+    const_iterator &operator++() {
+      ++ptr;
+      return *this;
+    }
+    const_iterator operator++(int) { return const_iterator(ptr++); }
+
+    const_iterator &operator--() {
+      --ptr;
+      return *this;
+    }
+    const_iterator operator--(int) { return const_iterator(ptr--); }
+
+    const T &operator*() const { return *ptr; }
+    const T *operator->() const { return ptr; }
+    const T &operator[](const difference_type &n) const { return ptr[n]; }
+
+    // non-members, so that an iterator on either side converts and can be
+    // compared with a const_iterator
+    friend bool operator==(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      return lhs.ptr == rhs.ptr;
+    }
+    friend bool operator!=(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      return lhs.ptr != rhs.ptr;
+    }
+    friend bool operator<(const const_iterator &lhs,
+                          const const_iterator &rhs) {
+      return lhs.ptr < rhs.ptr;
+    }
+    friend bool operator>(const const_iterator &lhs,
+                          const const_iterator &rhs) {
+      return rhs < lhs;
+    }
+    friend bool operator<=(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      return !(rhs < lhs);
+    }
+    friend bool operator>=(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      return !(lhs < rhs);
+    }
+  };
+
+private:
+  static constexpr size_t default_capacity = 8;
+  size_t head;
+  size_t _size;
+  size_t capacity;
+  T *store;
+
+  void clean() {
+    for (size_t i = 0; i < _size; i++)
+      store[head + i].~T();
+    operator delete[](store);
+  }
+
+  // moves the elements into a buffer of `new_capacity`, leaving
+  // `front_gap` free slots before them
+  void resize(size_t new_capacity, size_t front_gap) {
+    T *new_store = (T *)operator new[](sizeof(T) * new_capacity);
+    detail::relocate_disjoint(new_store + front_gap, store + head, _size);
+    operator delete[](store);
+    store = new_store;
+    capacity = new_capacity;
+    head = front_gap;
+  }
+
+  // reallocates with the elements centred, so both ends get the same room
+  void recentre(size_t new_capacity) {
+    resize(new_capacity, (new_capacity - _size) / 2);
+  }
+
+  void reserve_front() {
+    if (head > 0)
+      return;
+    if (_size * 2 < capacity) {
+      // plenty of room at the back; slide instead of growing
+      size_t new_head = (capacity - _size) / 2;
+      detail::relocate_backward(store + new_head, store, _size);
+      head = new_head;
+    } else {
+      recentre(capacity * 2);
+    }
+  }
+
+  void reserve_back() {
+    if (head + _size < capacity)
+      return;
+    if (_size * 2 < capacity) {
+      size_t new_head = (capacity - _size) / 2;
+      detail::relocate(store + new_head, store + head, _size);
+      head = new_head;
+    } else {
+      recentre(capacity * 2);
+    }
+  }
+
+  void shrink() {
+    if (_size <= capacity / 4 && capacity >= 4 * default_capacity)
+      recentre(capacity / 2);
+  }
+
+  // opens an unconstructed slot at `ind` by shifting the shorter side;
+  // returns whether that was the front
+  bool open_gap(size_t ind) {
+    if (ind < _size / 2) {
+      reserve_front();
+      detail::relocate(store + head - 1, store + head, ind);
+      head--;
+      return true;
+    }
+    reserve_back();
+    detail::relocate_backward(store + head + ind + 1, store + head + ind,
+                              _size - ind);
+    return false;
+  }
+
+  // the reverse of open_gap: shifts the elements on the `front` side of
+  // the unconstructed slot at `ind` back over it; _size excludes the slot
+  void close_gap(size_t ind, bool front) {
+    if (front) {
+      detail::relocate_backward(store + head + 1, store + head, ind);
+      head++;
+    } else {
+      detail::relocate(store + head + ind, store + head + ind + 1,
+                       _size - ind);
+    }
+  }
+
+  // an iterator that does not point into this devector throws
+  size_t index_of(const const_iterator &it) const {
+    if (it.ptr < store + head || it.ptr > store + head + _size)
+      throw invalid_iterator();
+    return it.ptr - (store + head);
+  }
+
+public:
+  devector()
+      : head(default_capacity / 2), _size(0), capacity(default_capacity),
+        store((T *)operator new[](sizeof(T) * default_capacity)) {}
+  devector(const devector &other)
+      : head(other.head), _size(other._size), capacity(other.capacity),
+        store((T *)operator new[](sizeof(T) * other.capacity)) {
+    try {
+      detail::uninitialized_copy_n(store + head, other.store + other.head,
+                                   _size);
+    } catch (...) {
+      operator delete[](store);
+      throw;
+    }
+  }
+  ~devector() { clean(); }
+  // copies into a new devector first, so a throwing copy leaves *this as
+  // it was
+  devector &operator=(const devector &other) {
+    if (this != &other) {
+      devector copy(other);
+      std::swap(head, copy.head);
+      std::swap(_size, copy._size);
+      std::swap(capacity, copy.capacity);
+      std::swap(store, copy.store);
+    }
+    return *this;
+  }
+
+  T &at(const size_t &pos) {
+    if (pos >= _size)
+      throw index_out_of_bound();
+    return store[head + pos];
+  }
+  const T &at(const size_t &pos) const {
+    if (pos >= _size)
+      throw index_out_of_bound();
+    return store[head + pos];
+  }
+
+  T &operator[](const size_t &pos) { return at(pos); }
+  const T &operator[](const size_t &pos) const { return at(pos); }
+
+  const T &front() const {
+    if (_size == 0)
+      throw container_is_empty();
+    return at(0);
+  }
+
+  const T &back() const {
+    if (_size == 0)
+      throw container_is_empty();
+    return at(_size - 1);
+  }
+
+  iterator begin() { return iterator(store + head); }
+  const_iterator begin() const { return const_iterator(store + head); }
+  const_iterator cbegin() const { return const_iterator(store + head); }
+
+  iterator end() { return iterator(store + head + _size); }
+  const_iterator end() const { return const_iterator(store + head + _size); }
+  const_iterator cend() const { return const_iterator(store + head + _size); }
+
+  bool empty() const { return (_size == 0); }
+
+  size_t size() const { return _size; }
+
+  void clear() {
+    clean();
+    head = default_capacity / 2;
+    capacity = default_capacity;
+    _size = 0;
+    store = (T *)operator new[](sizeof(T) * default_capacity);
+  }
+
+  // shifts whichever side of `ind` is shorter. The new element is built
+  // before anything moves, so a throwing copy leaves the devector as it
+  // was: at either end straight into the spare slot, in the middle (or
+  // when `value` lives in this devector) into a temporary.
+  iterator insert(const size_t &ind, const T &value) {
+    if (ind > _size)
+      throw index_out_of_bound();
+    bool inside = &value >= store + head && &value < store + head + _size;
+    if (ind == 0 && !inside) {
+      reserve_front();
+      new (store + head - 1) T(value);
+      head--;
+    } else if (ind == _size && !inside) {
+      reserve_back();
+      new (store + head + ind) T(value);
+    } else {
+      T copy(value);
+      bool front = open_gap(ind);
+      try {
+        new (store + head + ind) T(std::move_if_noexcept(copy));
+      } catch (...) {
+        close_gap(ind, front);
+        throw;
+      }
+    }
+    _size++;
+    return iterator(store + head + ind);
+  }
+
+  iterator insert(const_iterator pos, const T &value) {
+    return insert(index_of(pos), value);
+  }
+
+  iterator erase(const size_t &ind) {
+    if (ind >= _size)
+      throw index_out_of_bound();
+    bool front = ind < _size / 2;
+    store[head + ind].~T();
+    _size--;
+    close_gap(ind, front);
+    shrink();
+    return iterator(store + head + ind);
+  }
+
+  iterator erase(const_iterator pos) { return erase(index_of(pos)); }
+
+  void push_back(const T &value) { insert(_size, value); }
+
+  void pop_back() {
+    if (_size == 0)
+      throw container_is_empty();
+    erase(_size - 1);
+  }
+
+  void push_front(const T &value) { insert(0, value); }
+
+  void pop_front() {
+    if (_size == 0)
+      throw container_is_empty();
+    erase(0);
+  }
+};
+} // namespace sjtu
+
+#endif
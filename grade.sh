@@ -1,28 +1,119 @@
 #!/bin/bash
 
+# usage: ./grade.sh [--perf] [--update-baseline]
+#   --perf             build the tests with -O2 and check each one's wall time
+#                      and peak RSS against perf/baseline.txt
+#   --update-baseline  like --perf, but record the measurements as the new
+#                      baseline instead of checking them
+# PERF_THRESHOLD (percent, default 50) is how far a test may exceed its
+# baseline before it fails. Times under PERF_MIN_TIME seconds (default 0.1)
+# are treated as PERF_MIN_TIME, so tiny tests do not fail on noise.
+
+PERF=0
+UPDATE_BASELINE=0
+for arg in "$@"
+do
+    case $arg in
+        --perf) PERF=1 ;;
+        --update-baseline) PERF=1; UPDATE_BASELINE=1 ;;
+        *) echo "Unknown option" $arg; exit 1 ;;
+    esac
+done
+PERF_THRESHOLD=${PERF_THRESHOLD:-50}
+PERF_MIN_TIME=${PERF_MIN_TIME:-0.1}
+BASELINE=./perf/baseline.txt
+FAILED=0
+
 mkdir build
 
 cp ./vector.hpp ./build
 cp ./exceptions.hpp ./build
 cp ./utility.hpp ./build
+cp ./devector.hpp ./build
+cp ./small_vector.hpp ./build
+cp ./allocator.hpp ./build
+cp ./vector_stats.hpp ./build
+cp ./thread_pool.hpp ./build
+cp ./parallel.hpp ./build
+cp ./concurrent_vector.hpp ./build
 cp ./data/class-bint.hpp ./build
 cp ./data/class-integer.hpp ./build
 cp ./data/class-matrix.hpp ./build
 
+if [ $PERF -eq 1 ];
+then
+    CXXFLAGS="-O2"
+    g++ -O2 ./perf/measure.cpp -o ./build/measure
+    if [ $UPDATE_BASELINE -eq 1 ];
+    then
+        : > ${BASELINE}
+    fi;
+else
+    CXXFLAGS=""
+fi;
+
+# check_perf <test> <report-file>
+check_perf() {
+    read SECONDS_USED RSS_USED < $2
+    echo "Time" ${SECONDS_USED}"s, peak RSS" ${RSS_USED}"KiB"
+    if [ $UPDATE_BASELINE -eq 1 ];
+    then
+        echo $1 ${SECONDS_USED} ${RSS_USED} >> ../${BASELINE}
+        return
+    fi;
+    LINE=$(grep "^$1 " ../${BASELINE})
+    if [[ "$LINE" == "" ]]
+    then
+        echo "No baseline for" $1
+        return
+    fi;
+    read NAME BASE_SECONDS BASE_RSS <<< "$LINE"
+    VERDICT=$(awk -v t=${SECONDS_USED} -v bt=${BASE_SECONDS} \
+                  -v m=${RSS_USED} -v bm=${BASE_RSS} \
+                  -v th=${PERF_THRESHOLD} -v floor=${PERF_MIN_TIME} '
+        BEGIN {
+            if (t < floor) t = floor;
+            if (bt < floor) bt = floor;
+            limit = 1 + th / 100;
+            if (t > bt * limit) print "time";
+            else if (m > bm * limit) print "memory";
+            else print "ok";
+        }')
+    if [[ "$VERDICT" != "ok" ]]
+    then
+        echo "Fail performance test" $1"! ("${VERDICT}" regressed past" ${PERF_THRESHOLD}"% of" ${BASE_SECONDS}"s /" ${BASE_RSS}"KiB)"
+        FAILED=1
+    else
+        echo "Success performance test" $1"!"
+    fi;
+}
+
+# test_answer <test> [extra compiler flags]
 test_answer() {
     DIR=$1
     echo "Testing for" $1"... May take long..."
     cp ./data/${DIR}/code.cpp ./build
     cp ./data/${DIR}/answer.txt ./build
     cd build
-    g++ code.cpp -o code
-    ./code > tmp.txt
+    g++ ${CXXFLAGS} $2 code.cpp -o code
+    if [ $PERF -eq 1 ];
+    then
+        ./measure perf.txt ./code > tmp.txt
+    else
+        ./code > tmp.txt
+    fi;
     diff ./answer.txt ./tmp.txt
     if [ $? -ne 0 ];
     then
         echo "Fail test" $1"!"
+        FAILED=1
     else
         echo "Success test" $1"!"
+        if [ $PERF -eq 1 ];
+        then
+            check_perf $1 perf.txt
+            rm ./perf.txt
+        fi;
     fi;
     rm ./code.cpp ./answer.txt ./code ./tmp.txt
     cd ..
@@ -41,6 +132,7 @@ test_memory() {
     if [ $? -ne 0 ];
     then
         echo "Fail test" $1"!"
+        FAILED=1
     else
         valgrind --tool=memcheck --leak-check=full --log-file=log.txt ./code > tmp.txt
         flagA=0
@@ -74,5 +166,26 @@ test_memory two
 echo "------------------------Test Three-------------------------"
 test_answer three
 test_memory three
+echo "-------------------------Test Four-------------------------"
+test_answer four
+echo "-------------------------Test Five-------------------------"
+test_answer five
+echo "-------------------------Test Six--------------------------"
+test_answer six
+echo "------------------------Test Seven-------------------------"
+test_answer seven
+echo "------------------------Test Eight-------------------------"
+test_answer eight
+echo "-------------------------Test Nine-------------------------"
+test_answer nine
+echo "-------------------------Test Ten--------------------------"
+test_answer ten
+echo "------------------------Test Eleven------------------------"
+test_answer eleven
+echo "------------------------Test Twelve------------------------"
+test_answer twelve
+echo "-----------------------Test Thirteen-----------------------"
+test_answer thirteen -DSJTU_VECTOR_STATS
 
 rm -rf build
+exit $FAILED
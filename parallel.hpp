@@ -0,0 +1,274 @@
+#ifndef SJTU_PARALLEL_HPP
+#define SJTU_PARALLEL_HPP
+
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+namespace sjtu {
+// Parallel versions of a few standard algorithms over random-access ranges
+// such as vector iterators. Every algorithm also takes a par::policy as its
+// first argument. The functions passed in are called concurrently on
+// disjoint elements, and the binary operation of reduce must be
+// associative.
+namespace par {
+// Ranges shorter than serial_threshold run on the calling thread.
+// Otherwise the range is cut into pieces of about `grain` elements that
+// run on `pool`, or on thread_pool::global() when it is null.
+struct policy {
+  size_t grain = 4096;
+  size_t serial_threshold = 16384;
+  thread_pool *pool = nullptr;
+};
+
+namespace detail {
+inline thread_pool &pool_of(const policy &p) {
+  return p.pool ? *p.pool : thread_pool::global();
+}
+
+// calls fn(lo, hi) over pieces of [0, n)
+template <typename F> void chunked(const policy &p, size_t n, F fn) {
+  if (n == 0)
+    return;
+  if (n < p.serial_threshold)
+    fn(0, n);
+  else
+    pool_of(p).parallel_for(0, n, p.grain, fn);
+}
+} // namespace detail
+
+template <typename RandomIt, typename F>
+void for_each(const policy &p, RandomIt first, RandomIt last, F f) {
+  detail::chunked(p, last - first, [&](size_t lo, size_t hi) {
+    std::for_each(first + lo, first + hi, f);
+  });
+}
+
+template <typename RandomIt, typename F>
+void for_each(RandomIt first, RandomIt last, F f) {
+  par::for_each(policy(), first, last, f);
+}
+
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt transform(const policy &p, RandomIt first, RandomIt last,
+                   OutputIt d_first, UnaryOp op) {
+  size_t n = last - first;
+  detail::chunked(p, n, [&](size_t lo, size_t hi) {
+    std::transform(first + lo, first + hi, d_first + lo, op);
+  });
+  return d_first + n;
+}
+
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt transform(RandomIt first, RandomIt last, OutputIt d_first,
+                   UnaryOp op) {
+  return par::transform(policy(), first, last, d_first, op);
+}
+
+template <typename RandomIt1, typename RandomIt2, typename OutputIt,
+          typename BinaryOp>
+OutputIt transform(const policy &p, RandomIt1 first1, RandomIt1 last1,
+                   RandomIt2 first2, OutputIt d_first, BinaryOp op) {
+  size_t n = last1 - first1;
+  detail::chunked(p, n, [&](size_t lo, size_t hi) {
+    std::transform(first1 + lo, first1 + hi, first2 + lo, d_first + lo, op);
+  });
+  return d_first + n;
+}
+
+template <typename RandomIt1, typename RandomIt2, typename OutputIt,
+          typename BinaryOp>
+OutputIt transform(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2,
+                   OutputIt d_first, BinaryOp op) {
+  return par::transform(policy(), first1, last1, first2, d_first, op);
+}
+
+template <typename RandomIt, typename T>
+void fill(const policy &p, RandomIt first, RandomIt last, const T &value) {
+  detail::chunked(p, last - first, [&](size_t lo, size_t hi) {
+    std::fill(first + lo, first + hi, value);
+  });
+}
+
+template <typename RandomIt, typename T>
+void fill(RandomIt first, RandomIt last, const T &value) {
+  par::fill(policy(), first, last, value);
+}
+
+// folds every block of `grain` elements separately, starting from its first
+// element, then folds init and the block results in order; init only takes
+// part once, so it need not be an identity of `op`
+template <typename RandomIt, typename T, typename BinaryOp>
+T reduce(const policy &p, RandomIt first, RandomIt last, T init,
+         BinaryOp op) {
+  size_t n = last - first;
+  if (n < p.serial_threshold) {
+    for (; first != last; ++first)
+      init = op(std::move(init), *first);
+    return init;
+  }
+  size_t block = p.grain ? p.grain : 1;
+  vector<std::optional<T>> partial;
+  partial.insert(0, (n + block - 1) / block, std::optional<T>());
+  detail::pool_of(p).parallel_for(
+      0, partial.size(), 1, [&](size_t b_lo, size_t b_hi) {
+        for (size_t b = b_lo; b < b_hi; b++) {
+          RandomIt it = first + b * block,
+                   end = first + std::min(n, (b + 1) * block);
+          T acc = *it;
+          for (++it; it != end; ++it)
+            acc = op(std::move(acc), *it);
+          partial[b].emplace(std::move(acc));
+        }
+      });
+  for (size_t b = 0; b < partial.size(); b++)
+    init = op(std::move(init), std::move(*partial[b]));
+  return init;
+}
+
+template <typename RandomIt, typename T, typename BinaryOp>
+T reduce(RandomIt first, RandomIt last, T init, BinaryOp op) {
+  return par::reduce(policy(), first, last, std::move(init), op);
+}
+
+template <typename RandomIt, typename T>
+T reduce(const policy &p, RandomIt first, RandomIt last, T init) {
+  return par::reduce(p, first, last, std::move(init), std::plus<>());
+}
+
+template <typename RandomIt, typename T>
+T reduce(RandomIt first, RandomIt last, T init) {
+  return par::reduce(policy(), first, last, std::move(init), std::plus<>());
+}
+
+namespace detail {
+// one piece of a merge round: src[a, a_end) and src[b, b_end) merged into
+// dst from `out` on
+struct merge_piece {
+  size_t a, a_end, b, b_end, out;
+};
+
+// cuts the merge of the runs src[a, a_end) and src[b, b_end) into pieces
+// of at most `grain` (>= 2) elements: the longer run is split at its middle
+// element and the other one at the matching bound, so that everything
+// before the two split points goes before everything after them
+template <typename Src, typename Compare>
+void split_merge(Src src, size_t a, size_t a_end, size_t b, size_t b_end,
+                 size_t out, size_t grain, Compare &comp,
+                 vector<merge_piece> &pieces) {
+  while (a_end - a + b_end - b > grain) {
+    size_t am, bm;
+    if (a_end - a >= b_end - b) {
+      am = a + (a_end - a) / 2;
+      bm = std::lower_bound(src + b, src + b_end, src[am], comp) - src;
+    } else {
+      bm = b + (b_end - b) / 2;
+      am = std::upper_bound(src + a, src + a_end, src[bm], comp) - src;
+    }
+    split_merge(src, a, am, b, bm, out, grain, comp, pieces);
+    out += am - a + bm - b;
+    a = am;
+    b = bm;
+  }
+  pieces.push_back({a, a_end, b, b_end, out});
+}
+
+// std::merge that moves the elements; comp always sees lvalues
+template <typename Src, typename Dst, typename Compare>
+void move_merge(Src a, Src a_end, Src b, Src b_end, Dst out, Compare &comp) {
+  while (a != a_end && b != b_end) {
+    if (comp(*b, *a))
+      *out++ = std::move(*b++);
+    else
+      *out++ = std::move(*a++);
+  }
+  out = std::move(a, a_end, out);
+  std::move(b, b_end, out);
+}
+
+// merges every pair of neighbouring runs of `width` elements from src
+// into dst; the pieces of all the pairs run in parallel
+template <typename Src, typename Dst, typename Compare>
+void merge_round(thread_pool &pool, Src src, Dst dst, size_t n, size_t width,
+                 size_t grain, Compare &comp) {
+  vector<merge_piece> pieces;
+  for (size_t from = 0; from < n; from += 2 * width) {
+    size_t mid = std::min(n, from + width), to = std::min(n, from + 2 * width);
+    split_merge(src, from, mid, mid, to, from, grain, comp, pieces);
+  }
+  pool.parallel_for(0, pieces.size(), 1, [&](size_t lo, size_t hi) {
+    for (size_t i = lo; i < hi; i++) {
+      const merge_piece &m = pieces[i];
+      move_merge(src + m.a, src + m.a_end, src + m.b, src + m.b_end,
+                 dst + m.out, comp);
+    }
+  });
+}
+} // namespace detail
+
+// sorts blocks of `grain` elements in parallel, then merges neighbouring
+// runs pairwise. Each round moves the elements between the range and a
+// scratch buffer of the same length, with every merge cut into pieces of
+// about `grain` elements, so even the last round keeps all workers busy.
+// Not stable.
+template <typename RandomIt, typename Compare>
+void sort(const policy &p, RandomIt first, RandomIt last, Compare comp) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  size_t n = last - first;
+  if (n < p.serial_threshold) {
+    std::sort(first, last, comp);
+    return;
+  }
+  thread_pool &pool = detail::pool_of(p);
+  size_t block = p.grain ? p.grain : 1;
+  pool.parallel_for(0, (n + block - 1) / block, 1, [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; b++)
+      std::sort(first + b * block, first + std::min(n, (b + 1) * block),
+                comp);
+  });
+  if (block >= n)
+    return;
+  vector<T> scratch;
+  scratch.reserve(n);
+  for (RandomIt it = first; it != last; ++it)
+    scratch.push_back(std::move(*it));
+  T *buffer = scratch.data();
+  size_t grain = block < 2 ? 2 : block;
+  bool in_scratch = true;
+  for (size_t width = block; width < n; width *= 2) {
+    if (in_scratch)
+      detail::merge_round(pool, buffer, first, n, width, grain, comp);
+    else
+      detail::merge_round(pool, first, buffer, n, width, grain, comp);
+    in_scratch = !in_scratch;
+  }
+  if (in_scratch) {
+    pool.parallel_for(0, n, block, [&](size_t lo, size_t hi) {
+      std::move(buffer + lo, buffer + hi, first + lo);
+    });
+  }
+}
+
+template <typename RandomIt, typename Compare>
+void sort(RandomIt first, RandomIt last, Compare comp) {
+  par::sort(policy(), first, last, comp);
+}
+
+template <typename RandomIt>
+void sort(const policy &p, RandomIt first, RandomIt last) {
+  par::sort(p, first, last, std::less<>());
+}
+
+template <typename RandomIt> void sort(RandomIt first, RandomIt last) {
+  par::sort(policy(), first, last, std::less<>());
+}
+} // namespace par
+} // namespace sjtu
+
+#endif
@@ -0,0 +1,51 @@
+// Runs a command and reports its wall-clock time and peak resident set
+// size, for the performance gate in grade.sh.
+//
+// usage: measure <report-file> <command> [args...]
+// The report file gets one line: "<seconds> <peak-rss-KiB>". The exit
+// status is the command's.
+
+#include <chrono>
+#include <cstdio>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::fprintf(stderr, "usage: %s <report-file> <command> [args...]\n",
+                 argv[0]);
+    return 2;
+  }
+  auto start = std::chrono::steady_clock::now();
+  pid_t pid = fork();
+  if (pid < 0) {
+    std::perror("fork");
+    return 2;
+  }
+  if (pid == 0) {
+    execvp(argv[2], argv + 2);
+    std::perror("execvp");
+    _exit(127);
+  }
+  int status = 0;
+  struct rusage usage;
+  if (wait4(pid, &status, 0, &usage) < 0) {
+    std::perror("wait4");
+    return 2;
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  FILE *report = std::fopen(argv[1], "w");
+  if (report == nullptr) {
+    std::perror("fopen");
+    return 2;
+  }
+  // ru_maxrss is in KiB on Linux
+  std::fprintf(report, "%.3f %ld\n", seconds, usage.ru_maxrss);
+  std::fclose(report);
+  if (WIFEXITED(status))
+    return WEXITSTATUS(status);
+  return 128 + WTERMSIG(status);
+}
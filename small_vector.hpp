@@ -0,0 +1,460 @@
+#ifndef SJTU_SMALL_VECTOR_HPP
+#define SJTU_SMALL_VECTOR_HPP
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+#include <climits>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+// A vector that stores up to N elements inline and only moves them to the
+// heap once it outgrows that buffer. Same interface as sjtu::vector.
+template <typename T, size_t N> class small_vector {
+  static_assert(N > 0, "use sjtu::vector for N == 0");
+
+  friend class iterator;
+  friend class const_iterator;
+
+public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  // Iterators are plain pointers into the current buffer, as in
+  // sjtu::vector. Besides insert and erase, moving between the inline
+  // buffer and the heap invalidates them, and so does moving or swapping
+  // a small_vector whose elements are inline.
+  class const_iterator;
+  class iterator {
+    friend class small_vector;
+    friend class const_iterator;
+
+  private:
+    T *ptr;
+
+    explicit iterator(T *p) : ptr(p) {}
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+    using iterator_concept = std::contiguous_iterator_tag;
+#endif
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    iterator() = default;
+
+    iterator operator+(const difference_type &n) const {
+      return iterator(ptr + n);
+    }
+    friend iterator operator+(const difference_type &n, const iterator &it) {
+      return it + n;
+    }
+    iterator operator-(const difference_type &n) const {
+      return iterator(ptr - n);
+    }
+
+    difference_type operator-(const iterator &rhs) const {
+      return ptr - rhs.ptr;
+    }
+
+    iterator &operator+=(const difference_type &n) {
+      ptr += n;
+      return *this;
+    }
+    iterator &operator-=(const difference_type &n) {
+      ptr -= n;
+      return *this;
+    }
+
+    iterator &operator++() {
+      ++ptr;
+      return *this;
+    }
+    iterator operator++(int) { return iterator(ptr++); }
+
+    iterator &operator--() {
+      --ptr;
+      return *this;
+    }
+    iterator operator--(int) { return iterator(ptr--); }
+
+    T &operator*() const { return *ptr; }
+    T *operator->() const { return ptr; }
+    T &operator[](const difference_type &n) const { return ptr[n]; }
+
+    bool operator==(const iterator &rhs) const { return ptr == rhs.ptr; }
+    bool operator!=(const iterator &rhs) const { return ptr != rhs.ptr; }
+    bool operator<(const iterator &rhs) const { return ptr < rhs.ptr; }
+    bool operator>(const iterator &rhs) const { return rhs < *this; }
+    bool operator<=(const iterator &rhs) const { return !(rhs < *this); }
+    bool operator>=(const iterator &rhs) const { return !(*this < rhs); }
+  };
+  class const_iterator {
+    friend class small_vector;
+
+  private:
+    const T *ptr;
+
+    explicit const_iterator(const T *p) : ptr(p) {}
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+    using iterator_concept = std::contiguous_iterator_tag;
+#endif
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    const_iterator() = default;
+    const_iterator(const iterator &it) : ptr(it.ptr) {}
+
+    const_iterator operator+(const difference_type &n) const {
+      return const_iterator(ptr + n);
+    }
+    friend const_iterator operator+(const difference_type &n,
+                                    const const_iterator &it) {
+      return it + n;
+    }
+    const_iterator operator-(const difference_type &n) const {
+      return const_iterator(ptr - n);
+    }
+
+    difference_type operator-(const const_iterator &rhs) const {
+      return ptr - rhs.ptr;
+    }
+
+    const_iterator &operator+=(const difference_type &n) {
+      ptr += n;
+      return *this;
+    }
+    const_iterator &operator-=(const difference_type &n) {
+      ptr -= n;
+      return *this;
+    }
+
+    const_iterator &operator++() {
+      ++ptr;
+      return *this;
+    }
+    const_iterator operator++(int) { return const_iterator(ptr++); }
+
+    const_iterator &operator--() {
+      --ptr;
+      return *this;
+    }
+    const_iterator operator--(int) { return const_iterator(ptr--); }
+
+    const T &operator*() const { return *ptr; }
+    const T *operator->() const { return ptr; }
+    const T &operator[](const difference_type &n) const { return ptr[n]; }
+
+    // non-members, so that an iterator on either side converts and can be
+    // compared with a const_iterator
+    friend bool operator==(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      return lhs.ptr == rhs.ptr;
+    }
+    friend bool operator!=(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      return lhs.ptr != rhs.ptr;
+    }
+    friend bool operator<(const const_iterator &lhs,
+                          const const_iterator &rhs) {
+      return lhs.ptr < rhs.ptr;
+    }
+    friend bool operator>(const const_iterator &lhs,
+                          const const_iterator &rhs) {
+      return rhs < lhs;
+    }
+    friend bool operator<=(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      return !(rhs < lhs);
+    }
+    friend bool operator>=(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      return !(lhs < rhs);
+    }
+  };
+
+private:
+  size_t _size;
+  size_t _capacity;
+  T *store;
+  alignas(T) unsigned char buffer[sizeof(T) * N];
+
+  T *inline_store() { return reinterpret_cast<T *>(buffer); }
+  bool is_inline() const {
+    return store == reinterpret_cast<const T *>(buffer);
+  }
+
+  void clean() {
+    for (size_t i = 0; i < _size; i++)
+      store[i].~T();
+    if (!is_inline())
+      operator delete[](store);
+  }
+
+  void resize(size_t new_capacity) {
+    T *new_store = new_capacity <= N
+                       ? inline_store()
+                       : (T *)operator new[](sizeof(T) * new_capacity);
+    if (new_store == store)
+      return;
+    detail::relocate_disjoint(new_store, store, _size);
+    if (!is_inline())
+      operator delete[](store);
+    store = new_store;
+    _capacity = new_capacity <= N ? N : new_capacity;
+  }
+
+  // opens `n` uninitialized slots at `ind` and returns the first of them
+  T *make_gap(size_t ind, size_t n) {
+    if (n == 0)
+      return store + ind;
+    if (_size + n > _capacity)
+      resize(_capacity * 2 < _size + n ? _size + n : _capacity * 2);
+    detail::relocate_backward(store + ind + n, store + ind, _size - ind);
+    return store + ind;
+  }
+
+  // takes over the elements of `other`, which is left empty and inline;
+  // only an inline buffer needs its elements moved one by one
+  void steal(small_vector &other) {
+    if (other.is_inline()) {
+      store = inline_store();
+      _capacity = N;
+      detail::relocate_disjoint(store, other.store, other._size);
+    } else {
+      store = other.store;
+      _capacity = other._capacity;
+      other.store = other.inline_store();
+      other._capacity = N;
+    }
+    _size = other._size;
+    other._size = 0;
+  }
+
+  // an iterator that does not point into this vector throws
+  size_t index_of(const const_iterator &it) const {
+    if (it.ptr < store || it.ptr > store + _size)
+      throw invalid_iterator();
+    return it.ptr - store;
+  }
+
+public:
+  small_vector() : _size(0), _capacity(N), store(inline_store()) {}
+  small_vector(const small_vector &other)
+      : _size(0), _capacity(N), store(inline_store()) {
+    resize(other._size);
+    try {
+      detail::uninitialized_copy_n(store, other.store, other._size);
+    } catch (...) {
+      if (!is_inline())
+        operator delete[](store);
+      throw;
+    }
+    _size = other._size;
+  }
+  small_vector(small_vector &&other) noexcept(
+      std::is_nothrow_move_constructible<T>::value) {
+    steal(other);
+  }
+  ~small_vector() { clean(); }
+  // builds the copy in new storage and swaps it in, so a throwing copy
+  // leaves *this as it was; copies that cannot throw reuse the buffer
+  small_vector &operator=(const small_vector &other) {
+    if (this != &other) {
+      if constexpr (std::is_nothrow_copy_constructible<T>::value) {
+        reserve(other._size);
+        clear();
+        detail::uninitialized_copy_n(store, other.store, other._size);
+        _size = other._size;
+      } else {
+        small_vector copy(other);
+        swap(copy);
+      }
+    }
+    return *this;
+  }
+  small_vector &operator=(small_vector &&other) noexcept(
+      std::is_nothrow_move_constructible<T>::value) {
+    if (this != &other) {
+      clean();
+      steal(other);
+    }
+    return *this;
+  }
+
+  void swap(small_vector &other) {
+    if (!is_inline() && !other.is_inline()) {
+      std::swap(store, other.store);
+      std::swap(_size, other._size);
+      std::swap(_capacity, other._capacity);
+    } else {
+      small_vector tmp(std::move(other));
+      other = std::move(*this);
+      *this = std::move(tmp);
+    }
+  }
+
+  T &at(const size_t &pos) {
+    if (pos >= _size)
+      throw index_out_of_bound();
+    return store[pos];
+  }
+  const T &at(const size_t &pos) const {
+    if (pos >= _size)
+      throw index_out_of_bound();
+    return store[pos];
+  }
+
+  T &operator[](const size_t &pos) { return at(pos); }
+  const T &operator[](const size_t &pos) const { return at(pos); }
+
+  const T &front() const {
+    if (_size == 0)
+      throw container_is_empty();
+    return at(0);
+  }
+
+  const T &back() const {
+    if (_size == 0)
+      throw container_is_empty();
+    return at(_size - 1);
+  }
+
+  iterator begin() { return iterator(store); }
+  const_iterator begin() const { return const_iterator(store); }
+  const_iterator cbegin() const { return const_iterator(store); }
+
+  iterator end() { return iterator(store + _size); }
+  const_iterator end() const { return const_iterator(store + _size); }
+  const_iterator cend() const { return const_iterator(store + _size); }
+
+  bool empty() const { return (_size == 0); }
+
+  size_t size() const { return _size; }
+
+  size_t capacity() const { return _capacity; }
+
+  void reserve(size_t n) {
+    if (n > _capacity)
+      resize(n);
+  }
+
+  // moves the elements back inline when they fit
+  void shrink_to_fit() {
+    if (_size < _capacity)
+      resize(_size);
+  }
+
+  void clear() {
+    for (size_t i = 0; i < _size; i++)
+      store[i].~T();
+    _size = 0;
+  }
+
+  iterator insert(const size_t &ind, const T &value) {
+    return emplace(ind, value);
+  }
+
+  iterator insert(const_iterator pos, const T &value) {
+    return emplace(index_of(pos), value);
+  }
+
+  iterator insert(const size_t &ind, T &&value) {
+    return emplace(ind, std::move(value));
+  }
+
+  iterator insert(const_iterator pos, T &&value) {
+    return emplace(index_of(pos), std::move(value));
+  }
+
+  // the new element is built first, so `args` may refer to elements; if
+  // moving it into the gap throws (a copy-only T copies), the tail is
+  // shifted back over the gap
+  template <typename... Args>
+  iterator emplace(const size_t &ind, Args &&...args) {
+    if (ind > _size)
+      throw index_out_of_bound();
+    T tmp(std::forward<Args>(args)...);
+    T *gap = make_gap(ind, 1);
+    try {
+      new (gap) T(std::move(tmp));
+    } catch (...) {
+      detail::relocate(gap, gap + 1, _size - ind);
+      throw;
+    }
+    _size++;
+    return iterator(gap);
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args &&...args) {
+    return emplace(index_of(pos), std::forward<Args>(args)...);
+  }
+
+  template <typename... Args> T &emplace_back(Args &&...args) {
+    if (_size == _capacity)
+      emplace(_size, std::forward<Args>(args)...);
+    else {
+      new (store + _size) T(std::forward<Args>(args)...);
+      _size++;
+    }
+    return store[_size - 1];
+  }
+
+  iterator erase(const size_t &ind) {
+    if (ind >= _size)
+      throw index_out_of_bound();
+    store[ind].~T();
+    detail::relocate(store + ind, store + ind + 1, _size - ind - 1);
+    _size--;
+    return iterator(store + ind);
+  }
+
+  iterator erase(const_iterator pos) { return erase(index_of(pos)); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    size_t from = index_of(first), to = index_of(last);
+    if (from > to)
+      throw index_out_of_bound();
+    if (from == to)
+      return iterator(store + from);
+    for (size_t i = from; i < to; i++)
+      store[i].~T();
+    detail::relocate(store + from, store + to, _size - to);
+    _size -= to - from;
+    return iterator(store + from);
+  }
+
+  void push_back(const T &value) { emplace_back(value); }
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+
+  void pop_back() {
+    if (_size == 0)
+      throw container_is_empty();
+    erase(_size - 1);
+  }
+};
+
+template <typename T, size_t N>
+void swap(small_vector<T, N> &a, small_vector<T, N> &b) {
+  a.swap(b);
+}
+} // namespace sjtu
+
+#endif
@@ -0,0 +1,388 @@
+#ifndef SJTU_THREAD_POOL_HPP
+#define SJTU_THREAD_POOL_HPP
+
+#include "vector.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+// A fixed set of worker threads shared by everything in the process that
+// wants parallelism; thread_pool::global() is the default instance.
+// Each worker owns a lock-free deque of tasks. It runs its newest task
+// first and, once the deque is empty, steals the oldest task of another
+// worker, so a range split in halves keeps one half local while idle
+// workers take the big remaining pieces. Threads outside the pool queue
+// their tasks in one shared, locked queue.
+// A thread waiting in parallel_for() or wait() runs queued tasks
+// meanwhile, so tasks may submit and wait for tasks of their own.
+class thread_pool {
+  struct task {
+    virtual ~task() = default;
+    virtual void run() = 0;
+  };
+
+  template <typename F> struct task_of : task {
+    F fn;
+    explicit task_of(F &&f) : fn(std::move(f)) {}
+    void run() override { fn(); }
+  };
+
+  // Chase-Lev work-stealing deque. Only the owner pushes and takes, at the
+  // bottom, without locking; thieves take from the top with one
+  // compare-exchange. A full ring is replaced by one twice as big, but old
+  // rings are kept until the deque dies since a thief may still read them.
+  class deque {
+    struct slot {
+      std::atomic<task *> t{nullptr};
+      slot() = default;
+      // lets vector build the ring; slots are never copied once in use
+      slot(const slot &other) noexcept
+          : t(other.t.load(std::memory_order_relaxed)) {}
+    };
+
+    struct ring {
+      vector<slot> slots;
+      std::ptrdiff_t mask;
+
+      explicit ring(size_t n) : mask(n - 1) { slots.insert(0, n, slot()); }
+      task *get(std::ptrdiff_t i) const {
+        return slots[i & mask].t.load(std::memory_order_relaxed);
+      }
+      void put(std::ptrdiff_t i, task *t) {
+        slots[i & mask].t.store(t, std::memory_order_relaxed);
+      }
+    };
+
+    std::atomic<std::ptrdiff_t> top{0};
+    std::atomic<std::ptrdiff_t> bottom{0};
+    std::atomic<ring *> array;
+    vector<std::unique_ptr<ring>> rings;
+
+  public:
+    deque() {
+      rings.push_back(std::unique_ptr<ring>(new ring(64)));
+      array.store(rings[0].get(), std::memory_order_relaxed);
+    }
+
+    void push(task *t) {
+      std::ptrdiff_t b = bottom.load(std::memory_order_relaxed);
+      std::ptrdiff_t tp = top.load(std::memory_order_acquire);
+      ring *a = array.load(std::memory_order_relaxed);
+      if (b - tp > a->mask) {
+        ring *bigger = new ring((a->mask + 1) * 2);
+        for (std::ptrdiff_t i = tp; i < b; i++)
+          bigger->put(i, a->get(i));
+        rings.push_back(std::unique_ptr<ring>(bigger));
+        array.store(bigger, std::memory_order_release);
+        a = bigger;
+      }
+      a->put(b, t);
+      bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // the newest task, or nullptr
+    task *take() {
+      std::ptrdiff_t b = bottom.load(std::memory_order_relaxed) - 1;
+      ring *a = array.load(std::memory_order_relaxed);
+      bottom.store(b, std::memory_order_seq_cst);
+      std::ptrdiff_t tp = top.load(std::memory_order_seq_cst);
+      if (tp > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+      }
+      task *t = a->get(b);
+      if (tp == b) {
+        // the last task: race the thieves for it
+        if (!top.compare_exchange_strong(tp, tp + 1,
+                                         std::memory_order_seq_cst,
+                                         std::memory_order_relaxed))
+          t = nullptr;
+        bottom.store(b + 1, std::memory_order_relaxed);
+      }
+      return t;
+    }
+
+    // the oldest task, or nullptr if there is none or another thread won
+    // it first
+    task *steal() {
+      std::ptrdiff_t tp = top.load(std::memory_order_seq_cst);
+      std::ptrdiff_t b = bottom.load(std::memory_order_seq_cst);
+      if (tp >= b)
+        return nullptr;
+      task *t = array.load(std::memory_order_acquire)->get(tp);
+      if (!top.compare_exchange_strong(tp, tp + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed))
+        return nullptr;
+      return t;
+    }
+  };
+
+  struct current_thread {
+    const thread_pool *pool = nullptr;
+    size_t index = 0;
+    unsigned seed = 0;
+  };
+
+  size_t workers;
+  std::unique_ptr<deque[]> deques;
+  // tasks queued by outside threads: shared[shared_head, size)
+  std::mutex shared_lock;
+  vector<task *> shared;
+  size_t shared_head = 0;
+  vector<std::thread> threads;
+  std::atomic<size_t> queued{0};
+  std::atomic<size_t> sleeping{0};
+  bool stopping = false;
+  std::mutex sleep_lock;
+  std::condition_variable wake;
+
+  static current_thread &current() {
+    static thread_local current_thread c;
+    return c;
+  }
+
+  void push(task *t) {
+    // counted before it is visible: a thread may pop it, and decrement
+    // `queued`, as soon as it is published
+    queued++;
+    try {
+      const current_thread &c = current();
+      if (c.pool == this) {
+        deques[c.index].push(t);
+      } else {
+        std::lock_guard<std::mutex> guard(shared_lock);
+        shared.push_back(t);
+      }
+    } catch (...) {
+      queued--;
+      throw;
+    }
+    // a worker going to sleep counts itself before it checks `queued`, so
+    // one of the two sides always sees the other
+    if (sleeping.load() != 0) {
+      { std::lock_guard<std::mutex> guard(sleep_lock); }
+      wake.notify_one();
+    }
+  }
+
+  task *take_shared(bool newest) {
+    std::lock_guard<std::mutex> guard(shared_lock);
+    if (shared_head == shared.size())
+      return nullptr;
+    task *t;
+    if (newest) {
+      t = shared[shared.size() - 1];
+      shared.pop_back();
+    } else {
+      t = shared[shared_head++];
+    }
+    if (shared_head == shared.size()) {
+      shared.clear();
+      shared_head = 0;
+    }
+    return t;
+  }
+
+  // the calling thread's own newest task, else one stolen from a random
+  // victim
+  task *pop() {
+    current_thread &c = current();
+    bool worker = c.pool == this;
+    task *t = worker ? deques[c.index].take() : take_shared(true);
+    if (t == nullptr && workers != 0) {
+      c.seed = c.seed * 1103515245u + 12345u;
+      size_t start = (c.seed >> 8) % workers;
+      for (size_t i = 0; i < workers && t == nullptr; i++) {
+        size_t victim = (start + i) % workers;
+        if (!worker || victim != c.index)
+          t = deques[victim].steal();
+      }
+      if (t == nullptr && worker)
+        t = take_shared(false);
+    }
+    if (t)
+      queued--;
+    return t;
+  }
+
+  static void run(task *t) {
+    t->run();
+    delete t;
+  }
+
+  void work(size_t index) {
+    current() = {this, index, (unsigned)index * 2654435761u};
+    while (true) {
+      if (task *t = pop()) {
+        run(t);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_lock);
+      sleeping++;
+      wake.wait(lock, [this] { return stopping || queued.load() != 0; });
+      sleeping--;
+      if (stopping && queued.load() == 0)
+        return;
+    }
+  }
+
+  // wakes every started worker and joins it once the queues are empty
+  void stop() {
+    {
+      std::lock_guard<std::mutex> guard(sleep_lock);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < threads.size(); i++)
+      threads[i].join();
+  }
+
+  // runs one queued task, if there is any, on the calling thread
+  bool help() {
+    task *t = pop();
+    if (t == nullptr)
+      return false;
+    run(t);
+    return true;
+  }
+
+  template <typename F> void enqueue(F &&f) {
+    std::unique_ptr<task> t(new task_of<std::decay_t<F>>(std::forward<F>(f)));
+    push(t.get());
+    t.release();
+  }
+
+  // shared by the tasks of one parallel_for
+  template <typename F> struct loop {
+    F &fn;
+    size_t grain;
+    std::atomic<size_t> pending{1};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+
+    loop(F &f, size_t g) : fn(f), grain(g) {}
+  };
+
+  // runs fn over [lo, hi), queueing the upper halves until a piece is no
+  // longer than the grain. If a half cannot be queued, the loop fails
+  // with that exception and this piece stops without running fn.
+  template <typename F> void split(loop<F> &l, size_t lo, size_t hi) {
+    while (hi - lo > l.grain) {
+      size_t mid = lo + (hi - lo) / 2;
+      l.pending++;
+      try {
+        enqueue([this, &l, mid, hi] { split(l, mid, hi); });
+      } catch (...) {
+        l.pending--;
+        if (!l.failed.exchange(true))
+          l.error = std::current_exception();
+        break;
+      }
+      hi = mid;
+    }
+    if (!l.failed.load()) {
+      try {
+        l.fn(lo, hi);
+      } catch (...) {
+        if (!l.failed.exchange(true))
+          l.error = std::current_exception();
+      }
+    }
+    // the last thing done with `l`: the waiting caller may free it next
+    l.pending--;
+  }
+
+public:
+  // `count` workers besides the threads that wait on the pool; 0 runs
+  // everything on the waiting thread
+  explicit thread_pool(size_t count = std::thread::hardware_concurrency())
+      : workers(count), deques(new deque[count]) {
+    // if a thread fails to start, the ones already running must be joined
+    // before the exception leaves, or their std::thread destructors would
+    // terminate the program
+    try {
+      threads.reserve(workers);
+      for (size_t i = 0; i < workers; i++)
+        threads.push_back(std::thread([this, i] { work(i); }));
+    } catch (...) {
+      stop();
+      throw;
+    }
+  }
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+  // runs whatever is still queued, then joins the workers
+  ~thread_pool() {
+    stop();
+    while (help())
+      ;
+  }
+
+  // the pool used when none is given, sized to the machine
+  static thread_pool &global() {
+    static thread_pool pool;
+    return pool;
+  }
+
+  size_t size() const { return workers; }
+
+  // queues f(args...) and returns a future for its result; an exception
+  // thrown by f is stored in the future. Inside a task, use wait() rather
+  // than future::get() so that the worker keeps running tasks meanwhile.
+  template <typename F, typename... Args>
+  std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>>
+  submit(F &&f, Args &&...args) {
+    using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+    std::packaged_task<R()> job(
+        [fn = std::forward<F>(f),
+         bound = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+          return std::apply(std::move(fn), std::move(bound));
+        });
+    std::future<R> result = job.get_future();
+    enqueue(std::move(job));
+    return result;
+  }
+
+  // runs queued tasks until `f` is ready, then returns its result
+  template <typename R> R wait(std::future<R> &f) {
+    while (f.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      if (!help())
+        std::this_thread::yield();
+    }
+    return f.get();
+  }
+
+  // calls fn(lo, hi) on disjoint pieces of at most `grain` elements that
+  // cover [begin, end), and returns once all of them are done.
+  // If a call throws, the remaining pieces are skipped and the first
+  // exception is rethrown here.
+  template <typename F>
+  void parallel_for(size_t begin, size_t end, size_t grain, F fn) {
+    if (begin >= end)
+      return;
+    if (grain == 0)
+      grain = 1;
+    loop<F> l{fn, grain};
+    split(l, begin, end);
+    while (l.pending.load() != 0) {
+      if (!help())
+        std::this_thread::yield();
+    }
+    if (l.error)
+      std::rethrow_exception(l.error);
+  }
+};
+} // namespace sjtu
+
+#endif
@@ -5,174 +5,815 @@
 
 #include <climits>
 #include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#ifdef SJTU_VECTOR_STATS
+#include "vector_stats.hpp"
+#endif
 
 namespace sjtu {
-template <typename T> class vector {
+// Customization point: specialize to std::true_type for types that can be
+// moved to a new address with a plain memcpy, with the source then treated
+// as raw memory (e.g. a class that only owns a heap pointer).
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+namespace detail {
+// moves `n` elements from `src` to `dst` front to back, leaving `src`
+// destroyed; copies instead when T's move constructor may throw.
+// `dst` must not overlap the tail of `src`
+template <typename T> void relocate(T *dst, T *src, size_t n) {
+  if constexpr (is_trivially_relocatable<T>::value) {
+    if (n)
+      std::memmove((void *)dst, (const void *)src, sizeof(T) * n);
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      new (dst + i) T(std::move_if_noexcept(src[i]));
+      src[i].~T();
+    }
+  }
+}
+
+// same as relocate, but back to front so that `dst` may overlap the tail
+// of `src`
+template <typename T> void relocate_backward(T *dst, T *src, size_t n) {
+  if constexpr (is_trivially_relocatable<T>::value) {
+    if (n)
+      std::memmove((void *)dst, (const void *)src, sizeof(T) * n);
+  } else {
+    for (size_t i = n; i > 0; i--) {
+      new (dst + i - 1) T(std::move_if_noexcept(src[i - 1]));
+      src[i - 1].~T();
+    }
+  }
+}
+
+// relocation into a fresh, disjoint buffer
+template <typename T> void relocate_disjoint(T *dst, T *src, size_t n) {
+  if constexpr (is_trivially_relocatable<T>::value) {
+    if (n)
+      std::memcpy((void *)dst, (const void *)src, sizeof(T) * n);
+  } else {
+    relocate(dst, src, n);
+  }
+}
+
+// relocation falls back to copying, which may throw: T is neither
+// trivially relocatable nor nothrow movable, and its copy constructor is
+// not noexcept either. A throwing move-only type cannot be relocated
+// safely at all and gets no guarantee.
+template <typename T>
+struct relocation_may_throw
+    : std::bool_constant<!is_trivially_relocatable<T>::value &&
+                         !std::is_nothrow_move_constructible<T>::value &&
+                         std::is_copy_constructible<T>::value &&
+                         !std::is_nothrow_copy_constructible<T>::value> {};
+
+template <typename T> void destroy(T *p, size_t n) {
+  if constexpr (!std::is_trivially_destructible<T>::value) {
+    for (size_t i = 0; i < n; i++)
+      p[i].~T();
+  }
+}
+
+// constructs dst[0, n) from successive elements of `first`, all or
+// nothing: if a constructor throws, the ones already built are destroyed
+template <typename T, typename It>
+void uninitialized_copy_n(T *dst, It first, size_t n) {
+  size_t i = 0;
+  try {
+    for (; i < n; i++, ++first)
+      new (dst + i) T(*first);
+  } catch (...) {
+    destroy(dst, i);
+    throw;
+  }
+}
+
+// same as uninitialized_copy_n, with every element a copy of `value`
+template <typename T>
+void uninitialized_fill_n(T *dst, size_t n, const T &value) {
+  size_t i = 0;
+  try {
+    for (; i < n; i++)
+      new (dst + i) T(value);
+  } catch (...) {
+    destroy(dst, i);
+    throw;
+  }
+}
+
+template <typename It, typename = void>
+struct is_forward_iterator : std::false_type {};
+template <typename It>
+struct is_forward_iterator<
+    It, std::void_t<typename std::iterator_traits<It>::iterator_category>>
+    : std::is_base_of<std::forward_iterator_tag,
+                      typename std::iterator_traits<It>::iterator_category> {};
+} // namespace detail
+
+// Growth/shrink policy for vector:
+//  - the first allocation holds MinCapacity elements;
+//  - a full vector grows by a factor of GrowNum / GrowDen;
+//  - once at most 1/ShrinkDivisor of the capacity is used, the capacity is
+//    divided by ShrinkDivisor, as long as it stays at least MinCapacity.
+//    A larger divisor means more hysteresis; 0 never shrinks. With a
+//    MinCapacity of 0, an emptied vector gives its buffer back.
+// Any type with the same three members can be used instead.
+template <size_t GrowNum = 2, size_t GrowDen = 1, size_t MinCapacity = 8,
+          size_t ShrinkDivisor = 4>
+struct growth_policy {
+  static_assert(GrowNum > GrowDen, "vector must grow");
+  static_assert(ShrinkDivisor != 1, "use 0 to disable shrinking");
+
+  static constexpr size_t min_capacity = MinCapacity;
+
+  static size_t grow(size_t capacity) {
+    size_t grown = capacity / GrowDen * GrowNum +
+                   capacity % GrowDen * GrowNum / GrowDen;
+    return grown > capacity ? grown : capacity + 1;
+  }
+
+  static size_t shrink(size_t size, size_t capacity) {
+    if constexpr (ShrinkDivisor != 0) {
+      while (size <= capacity / ShrinkDivisor && capacity > MinCapacity &&
+             capacity >= ShrinkDivisor * MinCapacity)
+        capacity /= ShrinkDivisor;
+    }
+    return capacity;
+  }
+};
+
+template <typename T, typename Policy = growth_policy<>,
+          typename Allocator = std::allocator<T>>
+class vector;
+template <typename T, typename Policy, typename Allocator, typename Pred>
+size_t erase_if(vector<T, Policy, Allocator> &v, Pred pred);
+
+// insert, erase and reallocation give the strong exception guarantee.
+// For a T whose relocation may throw (see detail::relocation_may_throw,
+// e.g. a class with only a user-written copy constructor), that means an
+// insert or erase anywhere but the back copies the whole vector into a new
+// buffer, since shifting in place could fail halfway: O(size) copies and
+// one allocation each time, where std::vector shifts in place and only
+// gives the basic guarantee (see insert_middle and erase_middle in
+// bench/bench_vector.cpp). A noexcept move or copy constructor, or a
+// specialization of is_trivially_relocatable, avoids it.
+//
+// The allocator is a private base so that stateless allocators take no
+// space in the vector.
+template <typename T, typename Policy, typename Allocator>
+class vector : private Allocator {
+  static_assert(
+      std::is_same<typename Allocator::value_type, T>::value,
+      "Allocator::value_type must be T");
+
   friend class iterator;
   friend class const_iterator;
+  template <typename U, typename P, typename A, typename Pred>
+  friend size_t erase_if(vector<U, P, A> &v, Pred pred);
 
 public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using allocator_type = Allocator;
+
+  // Iterators are plain pointers into the buffer, so they are contiguous
+  // and random-access. With SJTU_VECTOR_DEBUG they also remember their
+  // vector and its generation at creation; using an iterator of another
+  // vector, or one that an insert/erase/reallocation has invalidated,
+  // throws invalid_iterator. Debug mode is stricter than the standard:
+  // an insert or erase that is not at the back invalidates every iterator,
+  // not only those after the position.
   class const_iterator;
   class iterator {
-    friend class vector<T>;
+    friend class vector;
+    friend class const_iterator;
 
   private:
-    vector<T> *vect;
-    size_t pos;
+    T *ptr;
+#ifdef SJTU_VECTOR_DEBUG
+    const vector *vect = nullptr;
+    size_t generation = 0;
+
+    iterator(T *p, const vector *v)
+        : ptr(p), vect(v), generation(v->generation) {}
+
+    void check_fresh() const {
+      if (vect == nullptr || generation != vect->generation)
+        throw invalid_iterator();
+    }
+#else
+    iterator(T *p, const vector *) : ptr(p) {}
+#endif
+
+    void check_deref([[maybe_unused]] const T *p) const {
+#ifdef SJTU_VECTOR_DEBUG
+      check_fresh();
+      if (p < vect->store || p >= vect->store + vect->_size)
+        throw invalid_iterator();
+#endif
+    }
 
-    iterator(vector<T> *v, size_t p) : vect(v), pos(p) {}
+    void check_same([[maybe_unused]] const iterator &rhs) const {
+#ifdef SJTU_VECTOR_DEBUG
+      if (vect != rhs.vect)
+        throw invalid_iterator();
+      if (vect != nullptr) {
+        check_fresh();
+        rhs.check_fresh();
+      }
+#endif
+    }
 
   public:
+    using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+    using iterator_concept = std::contiguous_iterator_tag;
+#endif
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
     iterator() = default;
 
-    iterator operator+(const size_t &n) const {
-      return iterator(vect, pos + n);
+    iterator operator+(const difference_type &n) const {
+      iterator it = *this;
+      return it += n;
+    }
+    friend iterator operator+(const difference_type &n, const iterator &it) {
+      return it + n;
     }
-    iterator operator-(const size_t &n) const {
-      return iterator(vect, pos - n);
+    iterator operator-(const difference_type &n) const {
+      iterator it = *this;
+      return it -= n;
     }
 
-    size_t operator-(const iterator &rhs) const {
-      if (vect != rhs.vect)
-        throw invalid_iterator();
-      return pos - rhs.pos;
+    difference_type operator-(const iterator &rhs) const {
+      check_same(rhs);
+      return ptr - rhs.ptr;
     }
 
-    iterator &operator+=(const size_t &n) {
-      pos += n;
+    iterator &operator+=(const difference_type &n) {
+      ptr += n;
       return *this;
     }
-    iterator &operator-=(const size_t &n) {
-      pos -= n;
+    iterator &operator-=(const difference_type &n) {
+      ptr -= n;
       return *this;
     }
 
-    iterator &operator++() { return *this += 1; }
+    iterator &operator++() {
+      ++ptr;
+      return *this;
+    }
     iterator operator++(int) {
-      ++(*this);
-      return *this - 1;
+      iterator it = *this;
+      ++ptr;
+      return it;
     }
 
-    iterator &operator--() { return *this -= 1; }
+    iterator &operator--() {
+      --ptr;
+      return *this;
+    }
     iterator operator--(int) {
-      --(*this);
-      return *this + 1;
+      iterator it = *this;
+      --ptr;
+      return it;
     }
 
-    T &operator*() const { return vect->store[pos]; }
-
-    bool operator==(const iterator &rhs) const {
-      return vect == rhs.vect && pos == rhs.pos;
+    T &operator*() const {
+      check_deref(ptr);
+      return *ptr;
+    }
+    T *operator->() const {
+      check_deref(ptr);
+      return ptr;
     }
-    bool operator==(const const_iterator &rhs) const {
-      return vect == rhs.vect && pos == rhs.pos;
+    T &operator[](const difference_type &n) const {
+      check_deref(ptr + n);
+      return ptr[n];
     }
 
+    bool operator==(const iterator &rhs) const {
+      check_same(rhs);
+      return ptr == rhs.ptr;
+    }
     bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
-    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    bool operator<(const iterator &rhs) const {
+      check_same(rhs);
+      return ptr < rhs.ptr;
+    }
+    bool operator>(const iterator &rhs) const { return rhs < *this; }
+    bool operator<=(const iterator &rhs) const { return !(rhs < *this); }
+    bool operator>=(const iterator &rhs) const { return !(*this < rhs); }
   };
   class const_iterator {
-    friend class vector<T>;
+    friend class vector;
 
   private:
-    const vector<T> *vect;
-    size_t pos;
+    const T *ptr;
+#ifdef SJTU_VECTOR_DEBUG
+    const vector *vect = nullptr;
+    size_t generation = 0;
+
+    const_iterator(const T *p, const vector *v)
+        : ptr(p), vect(v), generation(v->generation) {}
+
+    void check_fresh() const {
+      if (vect == nullptr || generation != vect->generation)
+        throw invalid_iterator();
+    }
+#else
+    const_iterator(const T *p, const vector *) : ptr(p) {}
+#endif
+
+    void check_deref([[maybe_unused]] const T *p) const {
+#ifdef SJTU_VECTOR_DEBUG
+      check_fresh();
+      if (p < vect->store || p >= vect->store + vect->_size)
+        throw invalid_iterator();
+#endif
+    }
 
-    const_iterator(const vector<T> *v, size_t p) : vect(v), pos(p) {}
+    void check_same([[maybe_unused]] const const_iterator &rhs) const {
+#ifdef SJTU_VECTOR_DEBUG
+      if (vect != rhs.vect)
+        throw invalid_iterator();
+      if (vect != nullptr) {
+        check_fresh();
+        rhs.check_fresh();
+      }
+#endif
+    }
 
   public:
+    using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+    using iterator_concept = std::contiguous_iterator_tag;
+#endif
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
     const_iterator() = default;
+#ifdef SJTU_VECTOR_DEBUG
+    const_iterator(const iterator &it)
+        : ptr(it.ptr), vect(it.vect), generation(it.generation) {}
+#else
+    const_iterator(const iterator &it) : ptr(it.ptr) {}
+#endif
 
-    const_iterator operator+(const size_t &n) const {
-      return const_iterator(vect, pos + n);
+    const_iterator operator+(const difference_type &n) const {
+      const_iterator it = *this;
+      return it += n;
+    }
+    friend const_iterator operator+(const difference_type &n,
+                                    const const_iterator &it) {
+      return it + n;
     }
-    const_iterator operator-(const size_t &n) const {
-      return const_iterator(vect, pos - n);
+    const_iterator operator-(const difference_type &n) const {
+      const_iterator it = *this;
+      return it -= n;
     }
 
-    size_t operator-(const const_iterator &rhs) const {
-      if (vect != rhs.vect)
-        throw invalid_iterator();
-      return pos - rhs.pos;
+    difference_type operator-(const const_iterator &rhs) const {
+      check_same(rhs);
+      return ptr - rhs.ptr;
     }
 
-    const_iterator &operator+=(const size_t &n) {
-      pos += n;
+    const_iterator &operator+=(const difference_type &n) {
+      ptr += n;
       return *this;
     }
-    const_iterator &operator-=(const size_t &n) {
-      pos -= n;
+    const_iterator &operator-=(const difference_type &n) {
+      ptr -= n;
       return *this;
     }
 
-    const_iterator &operator++() { return *this += 1; }
+    const_iterator &operator++() {
+      ++ptr;
+      return *this;
+    }
     const_iterator operator++(int) {
-      ++(*this);
-      return *this - 1;
+      const_iterator it = *this;
+      ++ptr;
+      return it;
     }
 
-    const_iterator &operator--() { return *this -= 1; }
+    const_iterator &operator--() {
+      --ptr;
+      return *this;
+    }
     const_iterator operator--(int) {
-      --(*this);
-      return *this + 1;
+      const_iterator it = *this;
+      --ptr;
+      return it;
     }
 
-    const T &operator*() const { return vect->store[pos]; }
-
-    bool operator==(const iterator &rhs) const {
-      return vect == rhs.vect && pos == rhs.pos;
+    const T &operator*() const {
+      check_deref(ptr);
+      return *ptr;
+    }
+    const T *operator->() const {
+      check_deref(ptr);
+      return ptr;
     }
-    bool operator==(const const_iterator &rhs) const {
-      return vect == rhs.vect && pos == rhs.pos;
+    const T &operator[](const difference_type &n) const {
+      check_deref(ptr + n);
+      return ptr[n];
     }
 
-    bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
-    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    // non-members, so that an iterator on either side converts and can be
+    // compared with a const_iterator
+    friend bool operator==(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      lhs.check_same(rhs);
+      return lhs.ptr == rhs.ptr;
+    }
+    friend bool operator!=(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      return !(lhs == rhs);
+    }
+    friend bool operator<(const const_iterator &lhs,
+                          const const_iterator &rhs) {
+      lhs.check_same(rhs);
+      return lhs.ptr < rhs.ptr;
+    }
+    friend bool operator>(const const_iterator &lhs,
+                          const const_iterator &rhs) {
+      return rhs < lhs;
+    }
+    friend bool operator<=(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      return !(rhs < lhs);
+    }
+    friend bool operator>=(const const_iterator &lhs,
+                           const const_iterator &rhs) {
+      return !(lhs < rhs);
+    }
   };
 
 private:
-  const size_t default_capacity = 8;
+  static constexpr size_t default_capacity = Policy::min_capacity;
   size_t _size;
-  size_t capacity;
+  size_t _capacity;
   T *store;
+#ifdef SJTU_VECTOR_DEBUG
+  size_t generation = 0;
+#endif
+
+  void invalidate_iterators() {
+#ifdef SJTU_VECTOR_DEBUG
+    generation++;
+#endif
+  }
+
+  // instrumentation hooks, empty unless SJTU_VECTOR_STATS is defined
+  void note_allocation([[maybe_unused]] size_t n) {
+#ifdef SJTU_VECTOR_STATS
+    stats().allocations++;
+    stats().bytes_allocated += sizeof(T) * n;
+    stats().note_capacity(n);
+#endif
+  }
+
+  void note_reallocation([[maybe_unused]] size_t new_capacity) {
+#ifdef SJTU_VECTOR_STATS
+    if (new_capacity < _capacity)
+      stats().shrinks++;
+    else if (_capacity != 0)
+      stats().reallocations++;
+#endif
+  }
+
+  void note_copies([[maybe_unused]] size_t n) {
+#ifdef SJTU_VECTOR_STATS
+    stats().copies += n;
+#endif
+  }
+
+  void note_moves([[maybe_unused]] size_t n) {
+#ifdef SJTU_VECTOR_STATS
+    stats().moves += n;
+#endif
+  }
+
+  // `n` elements went through detail::relocate and friends
+  void note_relocated([[maybe_unused]] size_t n) {
+#ifdef SJTU_VECTOR_STATS
+    if constexpr (is_trivially_relocatable<T>::value)
+      stats().bitwise_moves += n;
+    else if constexpr (std::is_nothrow_move_constructible<T>::value ||
+                       !std::is_copy_constructible<T>::value)
+      stats().moves += n;
+    else
+      stats().copies += n;
+#endif
+  }
+
+  // a T was built from Args; only building from another T counts
+  template <typename... Args> void note_construct() {
+#ifdef SJTU_VECTOR_STATS
+    if constexpr (sizeof...(Args) == 1 &&
+                  (std::is_same<std::decay_t<Args>, T>::value && ...)) {
+      if constexpr ((!std::is_lvalue_reference<Args>::value && ...))
+        note_moves(1);
+      else
+        note_copies(1);
+    }
+#endif
+  }
+
+  using alloc_traits = std::allocator_traits<Allocator>;
+
+  Allocator &alloc() { return *this; }
+  const Allocator &alloc() const { return *this; }
+
+  // a zero-sized request allocates nothing, so empty vectors stay off the
+  // heap until their first insertion
+  T *allocate(size_t n) {
+    if (n == 0)
+      return nullptr;
+    note_allocation(n);
+    return alloc_traits::allocate(alloc(), n);
+  }
+
+  void deallocate(T *p, size_t n) {
+    if (p)
+      alloc_traits::deallocate(alloc(), p, n);
+  }
 
   void clean() {
     for (size_t i = 0; i < _size; i++)
       store[i].~T();
-    operator delete[](store);
+    deallocate(store, _capacity);
+  }
+
+  // moves the elements into a new buffer of `new_capacity`, dropping the
+  // `erased` elements at `ind` and leaving `gap` slots there, which
+  // `fill(p)` constructs all or nothing before anything is moved, so it may
+  // still read the old elements. Strong guarantee: if the allocation,
+  // `fill` or a copying relocation throws, the vector is untouched.
+  template <typename Fill>
+  void rebuild(size_t new_capacity, size_t ind, size_t gap, size_t erased,
+               Fill fill) {
+    size_t tail = ind + erased, new_size = _size - erased + gap;
+    T *new_store = allocate(new_capacity);
+    try {
+      fill(new_store + ind);
+    } catch (...) {
+      deallocate(new_store, new_capacity);
+      throw;
+    }
+    invalidate_iterators();
+    note_reallocation(new_capacity);
+    note_relocated(_size - erased);
+    if constexpr (detail::relocation_may_throw<T>::value) {
+      // copy everything first so that the old buffer survives a failure
+      try {
+        detail::uninitialized_copy_n(new_store, store, ind);
+        try {
+          detail::uninitialized_copy_n(new_store + ind + gap, store + tail,
+                                       _size - tail);
+        } catch (...) {
+          detail::destroy(new_store, ind);
+          throw;
+        }
+      } catch (...) {
+        detail::destroy(new_store + ind, gap);
+        deallocate(new_store, new_capacity);
+        throw;
+      }
+      detail::destroy(store, _size);
+    } else {
+      detail::relocate_disjoint(new_store, store, ind);
+      detail::destroy(store + ind, erased);
+      detail::relocate_disjoint(new_store + ind + gap, store + tail,
+                                _size - tail);
+    }
+    deallocate(store, _capacity);
+    store = new_store;
+    _size = new_size;
+    _capacity = new_capacity;
   }
 
   void resize(size_t new_capacity) {
-    capacity = new_capacity;
-    T *new_store = (T *)operator new[](sizeof(T) * new_capacity);
-    for (size_t i = 0; i < _size; i++)
-      new (new_store + i) T(store[i]);
+    rebuild(new_capacity, _size, 0, 0, [](T *) {});
+  }
+
+  size_t next_capacity(size_t needed) const {
+    size_t grown =
+        _capacity ? Policy::grow(_capacity) : (size_t)default_capacity;
+    return grown < needed ? needed : grown;
+  }
+
+  // inserts `n` elements at `ind`, growing at most once; `fill(p)` must
+  // construct all of them at p or none. Strong guarantee: if anything
+  // throws, the vector is unchanged. When the capacity suffices the tail
+  // is shifted in place, unless shifting could throw halfway; then the
+  // elements are copied into a new buffer instead.
+  template <typename Fill> void insert_gap(size_t ind, size_t n, Fill fill) {
+    if (n == 0)
+      return;
+    if (_size + n > _capacity) {
+      rebuild(next_capacity(_size + n), ind, n, 0, fill);
+    } else if (ind == _size) {
+      fill(store + _size);
+      _size += n;
+    } else if constexpr (detail::relocation_may_throw<T>::value) {
+      rebuild(_capacity, ind, n, 0, fill);
+    } else {
+      invalidate_iterators();
+      note_relocated(_size - ind);
+      detail::relocate_backward(store + ind + n, store + ind, _size - ind);
+      try {
+        fill(store + ind);
+      } catch (...) {
+        detail::relocate(store + ind, store + ind + n, _size - ind);
+        throw;
+      }
+      _size += n;
+    }
+  }
+
+  // destroys the `n` elements at `ind` and closes the gap, with the same
+  // guarantee as insert_gap
+  void erase_gap(size_t ind, size_t n) {
+    if (n == 0)
+      return;
+    if (ind + n < _size) {
+      if constexpr (detail::relocation_may_throw<T>::value) {
+        rebuild(Policy::shrink(_size - n, _capacity), ind, 0, n, [](T *) {});
+        return;
+      }
+      invalidate_iterators();
+    }
+    detail::destroy(store + ind, n);
+    note_relocated(_size - ind - n);
+    detail::relocate(store + ind, store + ind + n, _size - ind - n);
+    _size -= n;
+    shrink();
+  }
+
+  size_t index_of(const const_iterator &it) const {
+#ifdef SJTU_VECTOR_DEBUG
+    if (it.vect != this)
+      throw invalid_iterator();
+    it.check_fresh();
+#endif
+    return it.ptr - store;
+  }
+
+  // destroys the elements and frees the buffer, leaving an empty vector
+  void release() {
+    invalidate_iterators();
     clean();
-    store = new_store;
+    _size = _capacity = 0;
+    store = nullptr;
+  }
+
+  // takes over the buffer of `other`, which must share our allocator;
+  // `other` is left empty
+  void steal(vector &other) {
+    other.invalidate_iterators();
+    _size = other._size;
+    _capacity = other._capacity;
+    store = other.store;
+    other._size = other._capacity = 0;
+    other.store = nullptr;
+  }
+
+  // makes the contents equal to src[0, n), each element passed on as Ref
+  // (const T & copies, T && moves). Live elements are assigned over, so
+  // their own buffers are reused, and only the size difference is
+  // constructed or destroyed; the buffer is replaced only when n exceeds
+  // the capacity. Types without that assignment are rebuilt in place.
+  template <typename Ref> void assign_elements(T *src, size_t n) {
+    invalidate_iterators();
+    if constexpr (std::is_rvalue_reference<Ref>::value)
+      note_moves(n);
+    else
+      note_copies(n);
+    if (n > _capacity) {
+      T *new_store = allocate(n);
+      size_t i = 0;
+      try {
+        for (; i < n; i++)
+          new (new_store + i) T(static_cast<Ref>(src[i]));
+      } catch (...) {
+        for (size_t j = 0; j < i; j++)
+          new_store[j].~T();
+        deallocate(new_store, n);
+        throw;
+      }
+      note_reallocation(n);
+      clean();
+      store = new_store;
+      _size = _capacity = n;
+      return;
+    }
+    size_t common = n < _size ? n : _size;
+    if constexpr (std::is_assignable<T &, Ref>::value) {
+      for (size_t i = 0; i < common; i++)
+        store[i] = static_cast<Ref>(src[i]);
+    } else {
+      // T cannot be assigned: rebuild the live elements in place
+      for (; _size > 0; _size--)
+        store[_size - 1].~T();
+    }
+    for (; _size < n; _size++)
+      new (store + _size) T(static_cast<Ref>(src[_size]));
+    for (; _size > n; _size--)
+      store[_size - 1].~T();
+  }
+
+  // gives memory back as the policy decides; after a bulk erase this still
+  // reallocates only once
+  void shrink() {
+    size_t new_capacity = Policy::shrink(_size, _capacity);
+    if (new_capacity < _capacity) {
+      try {
+        resize(new_capacity);
+      } catch (...) {
+        // keeping the bigger buffer is harmless, and the caller's
+        // operation has already succeeded
+      }
+    }
   }
 
 public:
-  vector()
-      : capacity(default_capacity), _size(0),
-        store((T *)operator new[](sizeof(T) * default_capacity)) {}
+  vector() : _size(0), _capacity(0), store(nullptr) {}
+  explicit vector(const Allocator &a)
+      : Allocator(a), _size(0), _capacity(0), store(nullptr) {}
   vector(const vector &other)
-      : capacity(other.capacity), _size(other._size),
-        store((T *)operator new[](sizeof(T) * other.capacity)) {
-    for (size_t i = 0; i < other._size; i++)
-      new (store + i) T(other.store[i]);
+      : Allocator(
+            alloc_traits::select_on_container_copy_construction(other.alloc())),
+        _size(other._size), _capacity(other._capacity),
+        store(allocate(other._capacity)) {
+    note_copies(_size);
+    try {
+      detail::uninitialized_copy_n(store, other.store, _size);
+    } catch (...) {
+      deallocate(store, _capacity);
+      throw;
+    }
+  }
+  vector(vector &&other) noexcept
+      : Allocator(std::move(other.alloc())), _size(other._size),
+        _capacity(other._capacity), store(other.store) {
+    other.invalidate_iterators();
+    other._size = other._capacity = 0;
+    other.store = nullptr;
   }
   ~vector() { clean(); }
   vector &operator=(const vector &other) {
     if (this != &other) {
-      clean();
-      capacity = other.capacity;
-      _size = other._size;
-      store = (T *)operator new[](sizeof(T) * capacity);
-      for (size_t i = 0; i < other._size; i++)
-        new (store + i) T(other.store[i]);
+      if constexpr (alloc_traits::propagate_on_container_copy_assignment::
+                        value) {
+        // the buffer must go back to the allocator that handed it out
+        if (!alloc_traits::is_always_equal::value && alloc() != other.alloc())
+          release();
+        alloc() = other.alloc();
+      }
+      assign_elements<const T &>(other.store, other._size);
     }
     return *this;
   }
+  vector &operator=(vector &&other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value) {
+    if (this == &other)
+      return *this;
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                      value) {
+      release();
+      alloc() = std::move(other.alloc());
+      steal(other);
+    } else if (alloc_traits::is_always_equal::value ||
+               alloc() == other.alloc()) {
+      release();
+      steal(other);
+    } else {
+      // a foreign buffer cannot be adopted, so move the elements instead
+      assign_elements<T &&>(other.store, other._size);
+    }
+    return *this;
+  }
+
+  Allocator get_allocator() const { return alloc(); }
 
   T &at(const size_t &pos) {
     if (pos >= _size)
@@ -185,8 +826,15 @@ public:
     return store[pos];
   }
 
+  // bounds-checked only with SJTU_VECTOR_DEBUG; use at() for a checked
+  // access in every build
+#ifdef SJTU_VECTOR_DEBUG
   T &operator[](const size_t &pos) { return at(pos); }
   const T &operator[](const size_t &pos) const { return at(pos); }
+#else
+  T &operator[](const size_t &pos) { return store[pos]; }
+  const T &operator[](const size_t &pos) const { return store[pos]; }
+#endif
 
   const T &front() const {
     if (_size == 0)
@@ -200,57 +848,191 @@ public:
     return at(_size - 1);
   }
 
-  iterator begin() { return iterator(this, 0); }
-  const_iterator cbegin() const { return const_iterator(this, 0); }
+  T *data() { return store; }
+  const T *data() const { return store; }
+
+  iterator begin() { return iterator(store, this); }
+  const_iterator begin() const { return const_iterator(store, this); }
+  const_iterator cbegin() const { return const_iterator(store, this); }
 
-  iterator end() { return iterator(this, _size); }
-  const_iterator cend() const { return const_iterator(this, _size); }
+  iterator end() { return iterator(store + _size, this); }
+  const_iterator end() const { return const_iterator(store + _size, this); }
+  const_iterator cend() const { return const_iterator(store + _size, this); }
 
   bool empty() const { return (_size == 0); }
 
   size_t size() const { return _size; }
 
+  size_t capacity() const { return _capacity; }
+
+  void reserve(size_t n) {
+    if (n > _capacity)
+      resize(n);
+  }
+
+  void shrink_to_fit() {
+    if (_size < _capacity)
+      resize(_size);
+  }
+
+#ifdef SJTU_VECTOR_STATS
+  // the counters shared by every vector of this instantiation
+  static vector_stats &stats() {
+    static vector_stats s(typeid(vector));
+    return s;
+  }
+#endif
+
+  // keeps the capacity, so refilling does not allocate
   void clear() {
-    clean();
-    capacity = default_capacity;
+    invalidate_iterators();
+    for (size_t i = 0; i < _size; i++)
+      store[i].~T();
     _size = 0;
-    store = (T *)operator new[](sizeof(T) * default_capacity);
   }
 
   iterator insert(const size_t &ind, const T &value) {
     if (ind > _size)
       throw index_out_of_bound();
-    if (_size == capacity)
-      resize(capacity * 2);
-    if (_size > ind) {
-      for (size_t i = _size - 1; i >= ind + 1; i--)
-        new (store + i + 1) T(store[i]);
-      new (store + ind + 1) T(store[ind]);
+    if (&value >= store && &value < store + _size) {
+      T copy(value);
+      return insert(ind, copy);
+    }
+    insert_gap(ind, 1, [&](T *p) { new (p) T(value); });
+    note_copies(1);
+    return iterator(store + ind, this);
+  }
+
+  iterator insert(const_iterator pos, const T &value) {
+    return insert(index_of(pos), value);
+  }
+
+  iterator insert(const size_t &ind, T &&value) {
+    if (ind > _size)
+      throw index_out_of_bound();
+    if (&value >= store && &value < store + _size) {
+      T tmp(std::move(value));
+      return insert(ind, std::move(tmp));
+    }
+    insert_gap(ind, 1, [&](T *p) { new (p) T(std::move(value)); });
+    note_moves(1);
+    return iterator(store + ind, this);
+  }
+
+  iterator insert(const_iterator pos, T &&value) {
+    return insert(index_of(pos), std::move(value));
+  }
+
+  iterator insert(const size_t &ind, size_t n, const T &value) {
+    if (ind > _size)
+      throw index_out_of_bound();
+    if (&value >= store && &value < store + _size) {
+      T copy(value);
+      return insert(ind, n, copy);
     }
-    new (store + ind) T(value);
-    _size++;
-    return iterator(this, ind);
+    insert_gap(ind, n,
+               [&](T *p) { detail::uninitialized_fill_n(p, n, value); });
+    note_copies(n);
+    return iterator(store + ind, this);
   }
 
-  iterator insert(iterator pos, const T &value) {
-    return insert(pos.pos, value);
+  iterator insert(const_iterator pos, size_t n, const T &value) {
+    return insert(index_of(pos), n, value);
+  }
+
+  // [first, last) must not point into this vector. Single-pass iterators
+  // are buffered first so that the tail is still shifted only once.
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral<InputIt>::value>>
+  iterator insert(const size_t &ind, InputIt first, InputIt last) {
+    if (ind > _size)
+      throw index_out_of_bound();
+    if constexpr (detail::is_forward_iterator<InputIt>::value) {
+      size_t n = std::distance(first, last);
+      insert_gap(ind, n,
+                 [&](T *p) { detail::uninitialized_copy_n(p, first, n); });
+      if constexpr (std::is_lvalue_reference<decltype(*first)>::value)
+        note_copies(n);
+      else
+        note_moves(n);
+    } else {
+      vector buffer(alloc());
+      for (; first != last; ++first)
+        buffer.push_back(*first);
+      insert(ind, std::make_move_iterator(buffer.store),
+             std::make_move_iterator(buffer.store + buffer._size));
+    }
+    return iterator(store + ind, this);
+  }
+
+  template <typename InputIt,
+            typename = std::enable_if_t<!std::is_integral<InputIt>::value>>
+  iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    return insert(index_of(pos), first, last);
+  }
+
+  template <typename InputIt> void append(InputIt first, InputIt last) {
+    insert(_size, first, last);
   }
 
   iterator erase(const size_t &ind) {
     if (ind >= _size)
       throw index_out_of_bound();
-    store[ind].~T();
-    for (size_t i = ind; i < _size - 1; i++)
-      new (store + i) T(store[i + 1]);
-    _size--;
-    if (_size <= capacity / 4 && capacity >= 4 * default_capacity)
-      resize(capacity / 4);
-    return iterator(this, ind);
+    erase_gap(ind, 1);
+    return iterator(store + ind, this);
   }
 
-  iterator erase(iterator pos) { return erase(pos.pos); }
+  iterator erase(const_iterator pos) { return erase(index_of(pos)); }
 
-  void push_back(const T &value) { insert(_size, value); }
+  iterator erase(const_iterator first, const_iterator last) {
+    size_t from = index_of(first), to = index_of(last);
+    if (from > to || to > _size)
+      throw index_out_of_bound();
+    if (from == to)
+      return iterator(store + from, this);
+    erase_gap(from, to - from);
+    return iterator(store + from, this);
+  }
+
+  // the arguments may refer to elements of this vector: away from the end
+  // the new element is built first and then moved into the gap
+  template <typename... Args>
+  iterator emplace(const size_t &ind, Args &&...args) {
+    if (ind > _size)
+      throw index_out_of_bound();
+    if (ind == _size) {
+      emplace_back(std::forward<Args>(args)...);
+    } else {
+      T tmp(std::forward<Args>(args)...);
+      insert_gap(ind, 1, [&](T *p) { new (p) T(std::move(tmp)); });
+      note_construct<Args...>();
+      note_moves(1);
+    }
+    return iterator(store + ind, this);
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args &&...args) {
+    return emplace(index_of(pos), std::forward<Args>(args)...);
+  }
+
+  // when growing, the new element is constructed in the new buffer before
+  // the old elements are moved, so `args` may still refer to them
+  template <typename... Args> T &emplace_back(Args &&...args) {
+    if (_size == _capacity)
+      rebuild(next_capacity(_size + 1), _size, 1, 0,
+              [&](T *p) { new (p) T(std::forward<Args>(args)...); });
+    else {
+      // counted only once built, so a throwing constructor changes nothing
+      new (store + _size) T(std::forward<Args>(args)...);
+      _size++;
+    }
+    note_construct<Args...>();
+    return store[_size - 1];
+  }
+
+  void push_back(const T &value) { emplace_back(value); }
+  void push_back(T &&value) { emplace_back(std::move(value)); }
 
   void pop_back() {
     if (_size == 0)
@@ -258,6 +1040,39 @@ public:
     erase(_size - 1);
   }
 };
+
+// removes every element satisfying `pred` in a single compaction pass and
+// returns how many were removed
+template <typename T, typename Policy, typename Allocator, typename Pred>
+size_t erase_if(vector<T, Policy, Allocator> &v, Pred pred) {
+  size_t kept = 0, i = 0;
+  try {
+    for (; i < v._size; i++) {
+      if (pred(v.store[i])) {
+        v.store[i].~T();
+      } else {
+        if (kept != i) {
+          v.note_relocated(1);
+          detail::relocate(v.store + kept, v.store + i, 1);
+        }
+        kept++;
+      }
+    }
+  } catch (...) {
+    // close the hole so the vector stays valid
+    v.invalidate_iterators();
+    if (kept != i)
+      detail::relocate(v.store + kept, v.store + i, v._size - i);
+    v._size = kept + v._size - i;
+    throw;
+  }
+  size_t removed = v._size - kept;
+  if (removed)
+    v.invalidate_iterators();
+  v._size = kept;
+  v.shrink();
+  return removed;
+}
 } // namespace sjtu
 
 #endif
\ No newline at end of file
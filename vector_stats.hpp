@@ -0,0 +1,79 @@
+#ifndef SJTU_VECTOR_STATS_HPP
+#define SJTU_VECTOR_STATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <typeinfo>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace sjtu {
+// Counters shared by every vector of one instantiation, fed by vector.hpp
+// when SJTU_VECTOR_STATS is defined. Every instance registers itself on
+// construction, and all of them are printed to stderr at exit.
+// The class is trivially destructible so that the counters are still
+// readable when the report runs.
+class vector_stats {
+public:
+  std::atomic<size_t> allocations{0};
+  std::atomic<size_t> bytes_allocated{0};
+  std::atomic<size_t> reallocations{0};
+  std::atomic<size_t> shrinks{0};
+  std::atomic<size_t> copies{0};
+  std::atomic<size_t> moves{0};
+  // elements moved with memcpy/memmove (trivially relocatable types)
+  std::atomic<size_t> bitwise_moves{0};
+  std::atomic<size_t> peak_capacity{0};
+
+  explicit vector_stats(const std::type_info &type) : name(type.name()) {
+#ifdef __GNUG__
+    int status = 0;
+    // deliberately never freed: the report needs it until exit
+    char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0)
+      name = demangled;
+#endif
+    next = head().load();
+    while (!head().compare_exchange_weak(next, this))
+      ;
+    static const bool registered = (std::atexit(report_at_exit), true);
+    (void)registered;
+  }
+
+  void note_capacity(size_t capacity) {
+    size_t peak = peak_capacity.load(std::memory_order_relaxed);
+    while (peak < capacity &&
+           !peak_capacity.compare_exchange_weak(peak, capacity,
+                                                std::memory_order_relaxed))
+      ;
+  }
+
+  static void report(FILE *out) {
+    for (vector_stats *s = head().load(); s; s = s->next)
+      std::fprintf(out,
+                   "%s: allocations=%zu bytes=%zu reallocations=%zu "
+                   "shrinks=%zu copies=%zu moves=%zu bitwise_moves=%zu "
+                   "peak_capacity=%zu\n",
+                   s->name, s->allocations.load(), s->bytes_allocated.load(),
+                   s->reallocations.load(), s->shrinks.load(),
+                   s->copies.load(), s->moves.load(), s->bitwise_moves.load(),
+                   s->peak_capacity.load());
+  }
+
+private:
+  const char *name;
+  vector_stats *next;
+
+  static std::atomic<vector_stats *> &head() {
+    static std::atomic<vector_stats *> list{nullptr};
+    return list;
+  }
+
+  static void report_at_exit() { report(stderr); }
+};
+} // namespace sjtu
+
+#endif